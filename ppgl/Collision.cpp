@@ -0,0 +1,360 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+#include "Collision.h"
+#include "CollisionKernels.h"
+#include "PPGL_Exception.h"
+
+#ifdef PPGL_COLLISION_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+#endif
+
+/*
+ * Helpers
+ */
+//Division rounding towards negative infinity
+static inline int floorDiv(int value, int divisor) {
+    int quotient = value / divisor;
+    return (value % divisor != 0 && ((value < 0) != (divisor < 0))) ? quotient - 1 : quotient;
+}
+
+static bool overlapScalar(const uint64_t *rowA, size_t strideA, const uint64_t *rowB, size_t strideB,
+                          uint32_t rowCount, int firstWord, int wordCount, int wordOffset, unsigned shift) {
+    for (uint32_t row = 0; row < rowCount; ++row) {
+        const uint64_t *a = rowA + row * strideA;
+        const uint64_t *b = rowB + row * strideB;
+
+        for (int w = firstWord; w < firstWord + wordCount; ++w) {
+            int k = w + wordOffset;
+            uint64_t wordB = shift == 0 ? b[k] : (b[k] >> shift) | (b[k + 1] << (64 - shift));
+            if(a[w] & wordB) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/*
+ * CPU feature detection
+ */
+#ifdef PPGL_COLLISION_X86
+static bool cpuSupportsSSE2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+static bool cpuSupportsAVX2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if(info[0] < 7) {
+        return false;
+    }
+    //The OS has to save the AVX registers
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if(!osxsave || !avx || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#else
+static bool cpuSupportsSSE2() { return false; }
+static bool cpuSupportsAVX2() { return false; }
+#endif
+
+//Returns the kernel of a backend, nullptr if unsupported by the CPU or the build
+static PPGL::OverlapKernel getKernel(PPGL::CollisionBackend backend) {
+    switch (backend) {
+        case PPGL::CollisionBackend::AVX2:
+            return cpuSupportsAVX2() ? PPGL::getOverlapKernelAVX2() : nullptr;
+        case PPGL::CollisionBackend::SSE2:
+            return cpuSupportsSSE2() ? PPGL::getOverlapKernelSSE2() : nullptr;
+        default:
+            return overlapScalar;
+    }
+}
+
+//Backend in use, the widest supported one is selected on first use
+struct SelectedKernel {
+    PPGL::CollisionBackend backend;
+    PPGL::OverlapKernel kernel;
+
+    SelectedKernel() : backend (PPGL::CollisionBackend::Scalar), kernel (overlapScalar) {
+        for (PPGL::CollisionBackend candidate : {PPGL::CollisionBackend::AVX2, PPGL::CollisionBackend::SSE2}) {
+            PPGL::OverlapKernel candidateKernel = getKernel(candidate);
+            if(candidateKernel != nullptr) {
+                backend = candidate;
+                kernel = candidateKernel;
+                break;
+            }
+        }
+    }
+};
+
+static SelectedKernel &selectedKernel() {
+    static SelectedKernel selected;
+    return selected;
+}
+
+/*
+ * Backend
+ */
+PPGL::CollisionBackend PPGL::getCollisionBackend() {
+    return selectedKernel().backend;
+}
+
+bool PPGL::setCollisionBackend(CollisionBackend backend) {
+    OverlapKernel kernel = getKernel(backend);
+    if(kernel == nullptr) {
+        return false;
+    }
+
+    selectedKernel().backend = backend;
+    selectedKernel().kernel = kernel;
+    return true;
+}
+
+/*
+ * CollisionMask
+ */
+PPGL::CollisionMask::CollisionMask(const uint8_t *pixels, uint32_t width, uint32_t height, uint32_t pixelStride,
+                                   uint32_t alphaOffset, uint8_t alphaThreshold) :
+        width (width), height (height)
+{
+    if(pixels == nullptr || width == 0 || height == 0 || alphaOffset >= pixelStride) {
+        std::cout << PPGL::Exception("Collision.cpp", __LINE__, "CollisionMask()", "Invalid texture");
+        throw std::runtime_error("Unable to create collision mask!");
+    }
+
+    wordsPerRow = (width + 63) / 64;
+    stride = leadingGuardWords + wordsPerRow + trailingGuardWords;
+    //Bits past the width and the guard words stay zero
+    words.assign(size_t(stride) * height, 0);
+
+    for (uint32_t y = 0; y < height; ++y) {
+        uint64_t *row = words.data() + size_t(y) * stride + leadingGuardWords;
+        const uint8_t *alpha = pixels + size_t(y) * width * pixelStride + alphaOffset;
+
+        for (uint32_t x = 0; x < width; ++x) {
+            if(alpha[size_t(x) * pixelStride] > alphaThreshold) {
+                row[x / 64] |= uint64_t(1) << (x % 64);
+            }
+        }
+    }
+}
+
+bool PPGL::CollisionMask::test(int x, int y) const {
+    if(x < 0 || y < 0 || uint32_t(x) >= width || uint32_t(y) >= height) {
+        return false;
+    }
+
+    return (getRow(uint32_t(y))[x / 64] >> (x % 64)) & 1;
+}
+
+/*
+ * Narrowphase
+ */
+bool PPGL::overlaps(const CollisionMask &a, int ax, int ay, const CollisionMask &b, int bx, int by) {
+    //Position of b relative to a
+    int dx = bx - ax;
+    int dy = by - ay;
+
+    //Overlapping rectangle in pixels of a
+    int left = std::max(0, dx);
+    int right = std::min(int(a.getWidth()), dx + int(b.getWidth()));
+    int top = std::max(0, dy);
+    int bottom = std::min(int(a.getHeight()), dy + int(b.getHeight()));
+    if(left >= right || top >= bottom) {
+        return false;
+    }
+
+    //Pixel x of a is pixel x - dx of b
+    int firstWord = left / 64;
+    int wordCount = (right - 1) / 64 - firstWord + 1;
+    int wordOffset = floorDiv(-dx, 64);
+    unsigned shift = unsigned(-dx - wordOffset * 64);
+
+    return selectedKernel().kernel(a.getRow(uint32_t(top)), a.getStride(), b.getRow(uint32_t(top - dy)),
+                                   b.getStride(), uint32_t(bottom - top), firstWord, wordCount, wordOffset, shift);
+}
+
+/*
+ * CollisionWorld
+ */
+PPGL::CollisionWorld::CollisionWorld(uint32_t cellSize) : cellSize (cellSize) {
+    if(cellSize == 0) {
+        std::cout << PPGL::Exception("Collision.cpp", __LINE__, "CollisionWorld()", "Cell size is zero");
+        throw std::runtime_error("Invalid collision cell size!");
+    }
+}
+
+uint32_t PPGL::CollisionWorld::addBody(const CollisionMask &mask, int x, int y) {
+    Body body = {&mask, x, y, true};
+
+    //Reuse the id of a removed body
+    if(!freeBodies.empty()) {
+        uint32_t id = freeBodies.back();
+        freeBodies.pop_back();
+        bodies[id] = body;
+        return id;
+    }
+
+    bodies.push_back(body);
+    return uint32_t(bodies.size() - 1);
+}
+
+void PPGL::CollisionWorld::removeBody(uint32_t id) {
+    if(id >= bodies.size() || !bodies[id].active) {
+        std::cout << PPGL::Exception("Collision.cpp", __LINE__, "removeBody()", "Invalid body id");
+        throw std::runtime_error("Invalid collision body id!");
+    }
+
+    bodies[id].active = false;
+    freeBodies.push_back(id);
+}
+
+void PPGL::CollisionWorld::setPosition(uint32_t id, int x, int y) {
+    Body &body = bodies.at(id);
+    body.x = x;
+    body.y = y;
+}
+
+const std::vector<std::pair<uint32_t, uint32_t>> &PPGL::CollisionWorld::findCollisions() {
+    const int cell = int(cellSize);
+    stats = {};
+    collisions.clear();
+
+    /*
+     * Insert every body into all grid cells its bounds cover
+     */
+    entries.clear();
+    for (uint32_t i = 0; i < bodies.size(); ++i) {
+        const Body &body = bodies[i];
+        if(!body.active) {
+            continue;
+        }
+
+        int cellLeft = floorDiv(body.x, cell);
+        int cellRight = floorDiv(body.x + int(body.mask->getWidth()) - 1, cell);
+        int cellTop = floorDiv(body.y, cell);
+        int cellBottom = floorDiv(body.y + int(body.mask->getHeight()) - 1, cell);
+        for (int cellY = cellTop; cellY <= cellBottom; ++cellY) {
+            for (int cellX = cellLeft; cellX <= cellRight; ++cellX) {
+                entries.push_back({cellX, cellY, i});
+            }
+        }
+    }
+
+    /*
+     * Sort the entries into hash buckets with a counting sort
+     */
+    uint32_t bucketCount = 64;
+    while (bucketCount < entries.size() * 2) {
+        bucketCount *= 2;
+    }
+    auto bucketOf = [bucketCount](int cellX, int cellY) {
+        return ((uint32_t(cellX) * 73856093u) ^ (uint32_t(cellY) * 19349663u)) & (bucketCount - 1);
+    };
+
+    bucketStarts.assign(bucketCount + 1, 0);
+    for (const CellEntry &entry : entries) {
+        ++bucketStarts[bucketOf(entry.cellX, entry.cellY) + 1];
+    }
+    for (uint32_t i = 0; i < bucketCount; ++i) {
+        bucketStarts[i + 1] += bucketStarts[i];
+    }
+    sortedEntries.resize(entries.size());
+    //Afterwards bucketStarts[i] holds the end of bucket i
+    for (const CellEntry &entry : entries) {
+        sortedEntries[bucketStarts[bucketOf(entry.cellX, entry.cellY)]++] = entry;
+    }
+
+    /*
+     * Test the pairs in every bucket
+     */
+    uint32_t bucketStart = 0;
+    for (uint32_t bucket = 0; bucket < bucketCount; ++bucket) {
+        uint32_t bucketEnd = bucketStarts[bucket];
+
+        for (uint32_t i = bucketStart; i < bucketEnd; ++i) {
+            const CellEntry &entryA = sortedEntries[i];
+            const Body &a = bodies[entryA.body];
+
+            for (uint32_t j = i + 1; j < bucketEnd; ++j) {
+                const CellEntry &entryB = sortedEntries[j];
+                //Different cells can share a bucket
+                if(entryA.cellX != entryB.cellX || entryA.cellY != entryB.cellY) {
+                    continue;
+                }
+                ++stats.broadphasePairs;
+
+                const Body &b = bodies[entryB.body];
+                int left = std::max(a.x, b.x);
+                int top = std::max(a.y, b.y);
+                if(left >= std::min(a.x + int(a.mask->getWidth()), b.x + int(b.mask->getWidth())) ||
+                   top >= std::min(a.y + int(a.mask->getHeight()), b.y + int(b.mask->getHeight()))) {
+                    continue;
+                }
+
+                //Pairs sharing several cells are only tested in the cell of the overlap's top left pixel
+                if(floorDiv(left, cell) != entryA.cellX || floorDiv(top, cell) != entryA.cellY) {
+                    continue;
+                }
+                ++stats.narrowphaseTests;
+
+                if(overlaps(*a.mask, a.x, a.y, *b.mask, b.x, b.y)) {
+                    collisions.emplace_back(std::min(entryA.body, entryB.body), std::max(entryA.body, entryB.body));
+                }
+            }
+        }
+
+        bucketStart = bucketEnd;
+    }
+    stats.collisions = uint32_t(collisions.size());
+
+    return collisions;
+}
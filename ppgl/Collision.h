@@ -0,0 +1,264 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+#ifndef PPGL_COLLISION_H
+#define PPGL_COLLISION_H
+
+/*
+ * Headers
+ */
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace PPGL {
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief 1-bit collision mask of a sprite, one bit per pixel.
+    /// \brief Rows are stored as 64-bit words with zeroed guard words
+    /// \brief around them, so the narrowphase can read past the edges.
+    /// \brief -
+    ///
+    ////////////////////////////////////////////////////////////////
+    class CollisionMask {
+    public:
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Generates the mask from the alpha channel of a texture.
+        /// \brief A pixel is solid if its alpha is greater than alphaThreshold.
+        /// \brief -
+        ///
+        /// \param pixels The pixels of the texture, rows are tightly packed.
+        /// \param width The width of the texture in pixels.
+        /// \param height The height of the texture in pixels.
+        /// \param pixelStride The size of one pixel in bytes, 4 for RGBA8.
+        /// \param alphaOffset The byte offset of the alpha value in a pixel, 3 for RGBA8.
+        /// \param alphaThreshold The alpha value a pixel needs to exceed to be solid.
+        ///
+        ////////////////////////////////////////////////////////////////
+        CollisionMask(const uint8_t *pixels, uint32_t width, uint32_t height, uint32_t pixelStride = 4,
+                      uint32_t alphaOffset = 3, uint8_t alphaThreshold = 0);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Checks a single pixel of the mask.
+        /// \brief -
+        ///
+        /// \return bool
+        /// \return TRUE if the pixel is solid
+        /// \return FALSE if the pixel is transparent or outside of the mask
+        ///
+        ////////////////////////////////////////////////////////////////
+        bool test(int x, int y) const;
+
+        //Getters
+        uint32_t getWidth() const { return width; }
+        uint32_t getHeight() const { return height; }
+        uint32_t getWordsPerRow() const { return wordsPerRow; }
+        //Distance between two rows in words, including guard words
+        uint32_t getStride() const { return stride; }
+        //Pointer to the first word of a row, the words before and after the row are zero
+        const uint64_t *getRow(uint32_t y) const { return words.data() + y * stride + leadingGuardWords; }
+
+        //Zero words before and after each row
+        static constexpr uint32_t leadingGuardWords = 1;
+        static constexpr uint32_t trailingGuardWords = 4;
+
+    private:
+        uint32_t width, height;
+        uint32_t wordsPerRow;
+        uint32_t stride;
+        std::vector<uint64_t> words;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Instruction sets the narrowphase can use.
+    /// \brief -
+    ///
+    ////////////////////////////////////////////////////////////////
+    enum class CollisionBackend {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Gets the narrowphase backend, by default the widest one the CPU supports.
+    /// \brief -
+    ///
+    ////////////////////////////////////////////////////////////////
+    CollisionBackend getCollisionBackend();
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Forces a narrowphase backend.
+    /// \brief -
+    ///
+    /// \param backend The backend to use.
+    ///
+    /// \return bool
+    /// \return TRUE if the backend is used from now on
+    /// \return FALSE if the backend is not supported by the CPU or the build
+    ///
+    ////////////////////////////////////////////////////////////////
+    bool setCollisionBackend(CollisionBackend backend);
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Pixel perfect test of two masks at integer pixel positions.
+    /// \brief -
+    ///
+    /// \param a The first mask.
+    /// \param ax,ay The position of the top left pixel of the first mask.
+    /// \param b The second mask.
+    /// \param bx,by The position of the top left pixel of the second mask.
+    ///
+    /// \return bool
+    /// \return TRUE if a solid pixel of both masks is at the same position
+    ///
+    ////////////////////////////////////////////////////////////////
+    bool overlaps(const CollisionMask &a, int ax, int ay, const CollisionMask &b, int bx, int by);
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Counters of the last CollisionWorld::findCollisions call
+    /// \brief -
+    ///
+    /// \param broadphasePairs Pairs sharing a grid cell.
+    /// \param narrowphaseTests Pairs with overlapping bounds tested pixel perfect.
+    /// \param collisions Pairs that collide.
+    ///
+    ////////////////////////////////////////////////////////////////
+    struct CollisionStats {
+        uint32_t broadphasePairs;
+        uint32_t narrowphaseTests;
+        uint32_t collisions;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Finds colliding bodies with a spatial hash grid broadphase
+    /// \brief and the pixel perfect narrowphase.
+    /// \brief -
+    ///
+    ////////////////////////////////////////////////////////////////
+    class CollisionWorld {
+    public:
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Creates an empty world.
+        /// \brief -
+        ///
+        /// \param cellSize The edge length of a grid cell in pixels, about the size of a typical sprite.
+        ///
+        ////////////////////////////////////////////////////////////////
+        explicit CollisionWorld(uint32_t cellSize = 64);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Adds a body, the mask has to outlive the body.
+        /// \brief -
+        ///
+        /// \return uint32_t
+        /// \return The id of the body
+        ///
+        ////////////////////////////////////////////////////////////////
+        uint32_t addBody(const CollisionMask &mask, int x, int y);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Removes a body, its id may be reused by addBody.
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void removeBody(uint32_t id);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Moves a body to a new position of its top left pixel.
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void setPosition(uint32_t id, int x, int y);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Finds all colliding pairs of bodies.
+        /// \brief -
+        ///
+        /// \return std::vector
+        /// \return The colliding pairs, lower id first, valid until the next call
+        ///
+        ////////////////////////////////////////////////////////////////
+        const std::vector<std::pair<uint32_t, uint32_t>> &findCollisions();
+
+        //Getters
+        const CollisionStats &getStats() const { return stats; }
+
+    private:
+        struct Body {
+            const CollisionMask *mask;
+            int x, y;
+            bool active;
+        };
+
+        //A body covering a grid cell
+        struct CellEntry {
+            int cellX, cellY;
+            uint32_t body;
+        };
+
+        uint32_t cellSize;
+        std::vector<Body> bodies;
+        std::vector<uint32_t> freeBodies;
+
+        //Reused between calls to avoid allocations
+        std::vector<CellEntry> entries;
+        std::vector<CellEntry> sortedEntries;
+        std::vector<uint32_t> bucketStarts;
+        std::vector<std::pair<uint32_t, uint32_t>> collisions;
+
+        CollisionStats stats{};
+    };
+}
+
+#endif //PPGL_COLLISION_H
@@ -0,0 +1,73 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+/*
+ * AVX2 narrowphase kernel, four mask words per step.
+ * This file is compiled with AVX2 enabled, the kernel is only called if the CPU supports it.
+ */
+#include "CollisionKernels.h"
+
+#if defined(PPGL_COLLISION_X86) && defined(__AVX2__)
+#include <immintrin.h>
+
+static bool overlapAVX2(const uint64_t *rowA, size_t strideA, const uint64_t *rowB, size_t strideB,
+                        uint32_t rowCount, int firstWord, int wordCount, int wordOffset, unsigned shift) {
+    //Shifting by 64 yields zero, so shift 0 needs no special case
+    const __m128i shiftRight = _mm_cvtsi32_si128(int(shift));
+    const __m128i shiftLeft = _mm_cvtsi32_si128(int(64 - shift));
+
+    for (uint32_t row = 0; row < rowCount; ++row) {
+        const uint64_t *a = rowA + row * strideA;
+        const uint64_t *b = rowB + row * strideB;
+
+        //Words past the overlap are zero in a or b, the guard words make reading them safe
+        __m256i hits = _mm256_setzero_si256();
+        for (int w = firstWord; w < firstWord + wordCount; w += 4) {
+            __m256i wordsA = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + w));
+            __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + (w + wordOffset)));
+            __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + (w + wordOffset + 1)));
+            __m256i wordsB = _mm256_or_si256(_mm256_srl_epi64(low, shiftRight), _mm256_sll_epi64(high, shiftLeft));
+            hits = _mm256_or_si256(hits, _mm256_and_si256(wordsA, wordsB));
+        }
+
+        if(!_mm256_testz_si256(hits, hits)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+PPGL::OverlapKernel PPGL::getOverlapKernelAVX2() {
+    return overlapAVX2;
+}
+
+#else
+
+PPGL::OverlapKernel PPGL::getOverlapKernelAVX2() {
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,72 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+#ifndef PPGL_COLLISIONKERNELS_H
+#define PPGL_COLLISIONKERNELS_H
+
+/*
+ * Headers
+ */
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define PPGL_COLLISION_X86
+#endif
+
+namespace PPGL {
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Narrowphase kernel, used internally by PPGL::overlaps.
+    /// \brief Tests rowCount rows of mask a against the rows of mask b.
+    /// \brief Word w of a row of a is tested against the bits of b starting at
+    /// \brief bit (w + wordOffset) * 64 + shift of the matching row of b.
+    /// \brief -
+    ///
+    /// \param rowA The first word of the first tested row of a.
+    /// \param strideA The stride of a in words.
+    /// \param rowB The first word of the first tested row of b.
+    /// \param strideB The stride of b in words.
+    /// \param rowCount The number of tested rows.
+    /// \param firstWord The first tested word of the rows of a.
+    /// \param wordCount The number of tested words per row of a.
+    /// \param wordOffset The word offset from a to b.
+    /// \param shift The bit offset from a to b, 0 to 63.
+    ///
+    /// \return bool
+    /// \return TRUE if any tested bits of a and b are both set
+    ///
+    ////////////////////////////////////////////////////////////////
+    typedef bool (*OverlapKernel)(const uint64_t *rowA, size_t strideA, const uint64_t *rowB, size_t strideB,
+                                  uint32_t rowCount, int firstWord, int wordCount, int wordOffset, unsigned shift);
+
+    //Kernels of the instruction sets, nullptr if the build does not support them
+    OverlapKernel getOverlapKernelSSE2();
+    OverlapKernel getOverlapKernelAVX2();
+}
+
+#endif //PPGL_COLLISIONKERNELS_H
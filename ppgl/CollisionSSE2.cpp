@@ -0,0 +1,73 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+/*
+ * SSE2 narrowphase kernel, two mask words per step
+ */
+#include "CollisionKernels.h"
+
+#ifdef PPGL_COLLISION_X86
+#include <emmintrin.h>
+
+static bool overlapSSE2(const uint64_t *rowA, size_t strideA, const uint64_t *rowB, size_t strideB,
+                        uint32_t rowCount, int firstWord, int wordCount, int wordOffset, unsigned shift) {
+    //Shifting by 64 yields zero, so shift 0 needs no special case
+    const __m128i shiftRight = _mm_cvtsi32_si128(int(shift));
+    const __m128i shiftLeft = _mm_cvtsi32_si128(int(64 - shift));
+    const __m128i zero = _mm_setzero_si128();
+
+    for (uint32_t row = 0; row < rowCount; ++row) {
+        const uint64_t *a = rowA + row * strideA;
+        const uint64_t *b = rowB + row * strideB;
+
+        //Words past the overlap are zero in a or b, the guard words make reading them safe
+        __m128i hits = zero;
+        for (int w = firstWord; w < firstWord + wordCount; w += 2) {
+            __m128i wordsA = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + w));
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + (w + wordOffset)));
+            __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + (w + wordOffset + 1)));
+            __m128i wordsB = _mm_or_si128(_mm_srl_epi64(low, shiftRight), _mm_sll_epi64(high, shiftLeft));
+            hits = _mm_or_si128(hits, _mm_and_si128(wordsA, wordsB));
+        }
+
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(hits, zero)) != 0xFFFF) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+PPGL::OverlapKernel PPGL::getOverlapKernelSSE2() {
+    return overlapSSE2;
+}
+
+#else
+
+PPGL::OverlapKernel PPGL::getOverlapKernelSSE2() {
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,322 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "Font.h"
+#include "PPGL_Exception.h"
+
+//Space kept free around every glyph so filtering does not bleed into neighbours
+static const uint32_t glyphPadding = 1;
+
+//Decodes the UTF-8 sequence at index and advances index past it
+static uint32_t decodeUtf8(const std::string &text, size_t &index) {
+    auto byte = uint8_t(text[index++]);
+    if(byte < 0x80) {
+        return byte;
+    }
+
+    uint32_t length;
+    uint32_t codepoint;
+    if((byte & 0xE0) == 0xC0) {
+        length = 1;
+        codepoint = byte & 0x1F;
+    } else if((byte & 0xF0) == 0xE0) {
+        length = 2;
+        codepoint = byte & 0x0F;
+    } else if((byte & 0xF8) == 0xF0) {
+        length = 3;
+        codepoint = byte & 0x07;
+    } else {
+        return 0xFFFD;
+    }
+
+    for (uint32_t i = 0; i < length; ++i) {
+        if(index >= text.size() || (uint8_t(text[index]) & 0xC0) != 0x80) {
+            return 0xFFFD;
+        }
+        codepoint = (codepoint << 6) | (uint8_t(text[index++]) & 0x3F);
+    }
+    return codepoint;
+}
+
+PPGL::BitmapGlyphSource::BitmapGlyphSource(const uint8_t *pixels, uint32_t width, uint32_t height,
+                                           uint32_t cellWidth, uint32_t cellHeight, uint32_t firstCodepoint,
+                                           uint32_t pixelStride, uint32_t alphaOffset) :
+        cellWidth (cellWidth), cellHeight (cellHeight), firstCodepoint (firstCodepoint), width (width)
+{
+    if(pixels == nullptr || cellWidth == 0 || cellHeight == 0 || cellWidth > width || cellHeight > height ||
+       alphaOffset >= pixelStride) {
+        std::cout << PPGL::Exception("Font.cpp", __LINE__, "BitmapGlyphSource()", "Invalid font image");
+        throw std::runtime_error("Unable to create bitmap font!");
+    }
+
+    columns = width / cellWidth;
+    cellCount = columns * (height / cellHeight);
+
+    coverage.resize(size_t(width) * height);
+    for (size_t i = 0; i < coverage.size(); ++i) {
+        coverage[i] = pixels[i * pixelStride + alphaOffset];
+    }
+}
+
+bool PPGL::BitmapGlyphSource::loadGlyph(uint32_t codepoint, GlyphBitmap &glyph) {
+    if(codepoint < firstCodepoint || codepoint - firstCodepoint >= cellCount) {
+        return false;
+    }
+
+    uint32_t cell = codepoint - firstCodepoint;
+    uint32_t cellX = (cell % columns) * cellWidth;
+    uint32_t cellY = (cell / columns) * cellHeight;
+
+    glyph.width = cellWidth;
+    glyph.height = cellHeight;
+    glyph.bearingX = 0.0f;
+    glyph.bearingY = float(cellHeight);
+    glyph.advance = float(cellWidth);
+    glyph.pixels.resize(size_t(cellWidth) * cellHeight);
+    for (uint32_t y = 0; y < cellHeight; ++y) {
+        std::memcpy(&glyph.pixels[size_t(y) * cellWidth], &coverage[size_t(cellY + y) * width + cellX], cellWidth);
+    }
+    return true;
+}
+
+PPGL::Font::Font(GlyphSource &source, FontType type, uint32_t pageSize, uint32_t sdfSpread) :
+        source (source), type (type), pageSize (pageSize), sdfSpread (type == FontType::SDF ? sdfSpread : 0)
+{
+    if(pageSize == 0 || (type == FontType::SDF && sdfSpread == 0)) {
+        std::cout << PPGL::Exception("Font.cpp", __LINE__, "Font()", "Invalid page size or SDF spread");
+        throw std::runtime_error("Unable to create font!");
+    }
+}
+
+const PPGL::FontGlyph &PPGL::Font::getGlyph(uint32_t codepoint) {
+    auto cached = glyphs.find(codepoint);
+    if(cached != glyphs.end()) {
+        return cached->second;
+    }
+
+    FontGlyph fontGlyph{};
+    GlyphBitmap bitmap{};
+    //Unknown glyphs are cached as well, they only advance the pen
+    if(source.loadGlyph(codepoint, bitmap)) {
+        if(type == FontType::SDF) {
+            generateSdf(bitmap);
+        }
+
+        fontGlyph.offsetX = bitmap.bearingX;
+        fontGlyph.offsetY = -bitmap.bearingY;
+        fontGlyph.advance = bitmap.advance;
+
+        if(bitmap.width > 0 && bitmap.height > 0) {
+            pack(bitmap.width, bitmap.height, fontGlyph.page, fontGlyph.x, fontGlyph.y);
+            fontGlyph.width = bitmap.width;
+            fontGlyph.height = bitmap.height;
+
+            Page &page = pages[fontGlyph.page];
+            for (uint32_t y = 0; y < bitmap.height; ++y) {
+                std::memcpy(&page.pixels[size_t(fontGlyph.y + y) * pageSize + fontGlyph.x],
+                            &bitmap.pixels[size_t(y) * bitmap.width], bitmap.width);
+            }
+
+            page.dirtyX0 = std::min(page.dirtyX0, fontGlyph.x);
+            page.dirtyY0 = std::min(page.dirtyY0, fontGlyph.y);
+            page.dirtyX1 = std::max(page.dirtyX1, fontGlyph.x + bitmap.width);
+            page.dirtyY1 = std::max(page.dirtyY1, fontGlyph.y + bitmap.height);
+        }
+    }
+
+    ++stats.cachedGlyphs;
+    return glyphs.emplace(codepoint, fontGlyph).first->second;
+}
+
+const PPGL::TextLayout &PPGL::Font::layout(const std::string &text) {
+    auto cached = layouts.find(text);
+    if(cached != layouts.end()) {
+        ++stats.layoutHits;
+        cached->second.lastUsed = frame;
+        return cached->second;
+    }
+    ++stats.layoutMisses;
+
+    TextLayout textLayout{};
+    textLayout.lastUsed = frame;
+    textLayout.glyphs.reserve(text.size());
+
+    float lineHeight = source.getLineHeight();
+    float penX = 0.0f;
+    float baseline = source.getAscent();
+    float scale = 1.0f / float(pageSize);
+    uint32_t previous = 0;
+    uint32_t lines = 1;
+
+    size_t index = 0;
+    while (index < text.size()) {
+        uint32_t codepoint = decodeUtf8(text, index);
+        if(codepoint == '\n') {
+            textLayout.width = std::max(textLayout.width, penX);
+            penX = 0.0f;
+            baseline += lineHeight;
+            previous = 0;
+            ++lines;
+            continue;
+        }
+
+        if(previous != 0) {
+            penX += source.getKerning(previous, codepoint);
+        }
+        previous = codepoint;
+
+        const FontGlyph &glyph = getGlyph(codepoint);
+        if(glyph.width > 0) {
+            textLayout.glyphs.push_back({penX + glyph.offsetX, baseline + glyph.offsetY,
+                                         float(glyph.width), float(glyph.height),
+                                         float(glyph.x) * scale, float(glyph.y) * scale,
+                                         float(glyph.x + glyph.width) * scale, float(glyph.y + glyph.height) * scale,
+                                         glyph.page});
+        }
+        penX += glyph.advance;
+    }
+    textLayout.width = std::max(textLayout.width, penX);
+    textLayout.height = float(lines) * lineHeight;
+
+    ++stats.cachedLayouts;
+    return layouts.emplace(text, std::move(textLayout)).first->second;
+}
+
+void PPGL::Font::collectLayouts(uint32_t maxUnusedFrames) {
+    for (auto layout = layouts.begin(); layout != layouts.end();) {
+        if(frame - layout->second.lastUsed >= maxUnusedFrames) {
+            layout = layouts.erase(layout);
+            --stats.cachedLayouts;
+        } else {
+            ++layout;
+        }
+    }
+    ++frame;
+}
+
+bool PPGL::Font::getDirtyRect(uint32_t page, uint32_t &x, uint32_t &y, uint32_t &width, uint32_t &height) const {
+    const Page &dirtyPage = pages.at(page);
+    if(dirtyPage.dirtyX0 >= dirtyPage.dirtyX1) {
+        return false;
+    }
+
+    x = dirtyPage.dirtyX0;
+    y = dirtyPage.dirtyY0;
+    width = dirtyPage.dirtyX1 - dirtyPage.dirtyX0;
+    height = dirtyPage.dirtyY1 - dirtyPage.dirtyY0;
+    return true;
+}
+
+void PPGL::Font::clearDirtyRect(uint32_t page, uint32_t rows) {
+    Page &dirtyPage = pages.at(page);
+    if(dirtyPage.dirtyY0 < dirtyPage.dirtyY1 && rows < dirtyPage.dirtyY1 - dirtyPage.dirtyY0) {
+        dirtyPage.dirtyY0 += rows;
+        return;
+    }
+
+    dirtyPage.dirtyX0 = dirtyPage.dirtyY0 = pageSize;
+    dirtyPage.dirtyX1 = dirtyPage.dirtyY1 = 0;
+}
+
+void PPGL::Font::pack(uint32_t width, uint32_t height, uint32_t &page, uint32_t &x, uint32_t &y) {
+    if(width + glyphPadding > pageSize || height + glyphPadding > pageSize) {
+        std::cout << PPGL::Exception("Font.cpp", __LINE__, "pack()", "Glyph is larger than an atlas page");
+        throw std::runtime_error("Unable to cache glyph!");
+    }
+
+    if(!pages.empty()) {
+        Page &open = pages.back();
+        //Start a new shelf if the glyph does not fit next to the last one
+        if(open.cursorX + width + glyphPadding > pageSize) {
+            open.shelfY += open.shelfHeight;
+            open.shelfHeight = 0;
+            open.cursorX = 0;
+        }
+    }
+
+    //Start a new page if the glyph does not fit below the last shelf
+    if(pages.empty() || pages.back().shelfY + height + glyphPadding > pageSize) {
+        Page newPage{};
+        newPage.pixels.resize(size_t(pageSize) * pageSize, 0);
+        newPage.dirtyX0 = newPage.dirtyY0 = pageSize;
+        pages.push_back(std::move(newPage));
+    }
+
+    Page &open = pages.back();
+    page = uint32_t(pages.size() - 1);
+    x = open.cursorX;
+    y = open.shelfY;
+    open.cursorX += width + glyphPadding;
+    open.shelfHeight = std::max(open.shelfHeight, height + glyphPadding);
+}
+
+void PPGL::Font::generateSdf(GlyphBitmap &glyph) const {
+    auto spread = int32_t(sdfSpread);
+    auto width = int32_t(glyph.width);
+    auto height = int32_t(glyph.height);
+    int32_t sdfWidth = width + 2 * spread;
+    int32_t sdfHeight = height + 2 * spread;
+
+    auto inside = [&](int32_t x, int32_t y) {
+        return x >= 0 && y >= 0 && x < width && y < height && glyph.pixels[size_t(y) * width + x] >= 128;
+    };
+
+    std::vector<uint8_t> sdf(size_t(sdfWidth) * sdfHeight);
+    for (int32_t y = 0; y < sdfHeight; ++y) {
+        for (int32_t x = 0; x < sdfWidth; ++x) {
+            int32_t sourceX = x - spread;
+            int32_t sourceY = y - spread;
+            bool state = inside(sourceX, sourceY);
+
+            //Squared distance to the nearest pixel of the opposite state within the spread
+            int32_t nearest = (spread + 1) * (spread + 1);
+            for (int32_t offsetY = -spread; offsetY <= spread; ++offsetY) {
+                for (int32_t offsetX = -spread; offsetX <= spread; ++offsetX) {
+                    int32_t distance = offsetX * offsetX + offsetY * offsetY;
+                    if(distance < nearest && inside(sourceX + offsetX, sourceY + offsetY) != state) {
+                        nearest = distance;
+                    }
+                }
+            }
+
+            //The outline lies half a pixel between both pixels
+            float distance = std::min(std::sqrt(float(nearest)), float(spread)) - 0.5f;
+            float value = 0.5f + (state ? distance : -distance) / float(2 * spread);
+            sdf[size_t(y) * sdfWidth + x] = uint8_t(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+    }
+
+    glyph.pixels = std::move(sdf);
+    glyph.width = uint32_t(sdfWidth);
+    glyph.height = uint32_t(sdfHeight);
+    glyph.bearingX -= float(spread);
+    glyph.bearingY += float(spread);
+}
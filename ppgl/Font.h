@@ -0,0 +1,338 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+#ifndef PPGL_FONT_H
+#define PPGL_FONT_H
+
+/*
+ * Headers
+ */
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace PPGL {
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Rasterized glyph delivered by a GlyphSource
+    /// \brief -
+    ///
+    /// \param width The width of the bitmap in pixels.
+    /// \param height The height of the bitmap in pixels.
+    /// \param bearingX The distance from the pen position to the left edge of the bitmap.
+    /// \param bearingY The distance from the baseline up to the top edge of the bitmap.
+    /// \param advance The distance the pen moves after the glyph.
+    /// \param pixels The coverage of every pixel, rows are tightly packed.
+    ///
+    ////////////////////////////////////////////////////////////////
+    struct GlyphBitmap {
+        uint32_t width, height;
+        float bearingX, bearingY;
+        float advance;
+        std::vector<uint8_t> pixels;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Rasterizes glyphs for a Font, implement it to plug in a font library
+    /// \brief -
+    ///
+    ////////////////////////////////////////////////////////////////
+    class GlyphSource {
+    public:
+        virtual ~GlyphSource() = default;
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Rasterizes a glyph.
+        /// \brief -
+        ///
+        /// \param codepoint The unicode codepoint of the glyph.
+        /// \param glyph Receives the glyph.
+        ///
+        /// \return bool
+        /// \return FALSE if the font has no glyph for the codepoint
+        ///
+        ////////////////////////////////////////////////////////////////
+        virtual bool loadGlyph(uint32_t codepoint, GlyphBitmap &glyph) = 0;
+
+        //Distance between two baselines
+        virtual float getLineHeight() const = 0;
+        //Distance from the top of a line to its baseline
+        virtual float getAscent() const = 0;
+        //Pen adjustment between two glyphs
+        virtual float getKerning(uint32_t, uint32_t) const { return 0.0f; }
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Monospaced bitmap font stored as a grid of glyph cells in an image
+    /// \brief -
+    ///
+    ////////////////////////////////////////////////////////////////
+    class BitmapGlyphSource : public GlyphSource {
+    public:
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Copies the glyph cells out of an image.
+        /// \brief -
+        ///
+        /// \param pixels The pixels of the image, rows are tightly packed.
+        /// \param width The width of the image in pixels.
+        /// \param height The height of the image in pixels.
+        /// \param cellWidth The width of a glyph cell.
+        /// \param cellHeight The height of a glyph cell.
+        /// \param firstCodepoint The codepoint of the top left cell, following cells are row by row.
+        /// \param pixelStride The size of one pixel in bytes, 4 for RGBA8.
+        /// \param alphaOffset The byte offset of the coverage in a pixel, 3 for RGBA8.
+        ///
+        ////////////////////////////////////////////////////////////////
+        BitmapGlyphSource(const uint8_t *pixels, uint32_t width, uint32_t height, uint32_t cellWidth,
+                          uint32_t cellHeight, uint32_t firstCodepoint = 32, uint32_t pixelStride = 4,
+                          uint32_t alphaOffset = 3);
+
+        bool loadGlyph(uint32_t codepoint, GlyphBitmap &glyph) override;
+        float getLineHeight() const override { return float(cellHeight); }
+        float getAscent() const override { return float(cellHeight); }
+
+    private:
+        uint32_t cellWidth, cellHeight;
+        uint32_t firstCodepoint;
+        uint32_t cellCount;
+        uint32_t columns;
+        //Coverage of the whole image
+        std::vector<uint8_t> coverage;
+        uint32_t width;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief How glyphs are stored in the atlas
+    /// \brief -
+    ///
+    ////////////////////////////////////////////////////////////////
+    enum class FontType {
+        //Coverage, sampled with nearest filtering for crisp pixels
+        Bitmap,
+        //Signed distance field, scales smoothly
+        SDF
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Glyph in the atlas of a font
+    /// \brief -
+    ///
+    ////////////////////////////////////////////////////////////////
+    struct FontGlyph {
+        uint32_t page;
+        //Rectangle in the page in pixels
+        uint32_t x, y, width, height;
+        //Top left of the rectangle relative to the pen position on the baseline, y pointing down
+        float offsetX, offsetY;
+        float advance;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Positioned glyph quad of a laid out text
+    /// \brief -
+    ///
+    ////////////////////////////////////////////////////////////////
+    struct TextLayoutGlyph {
+        //Quad relative to the top left of the text in pixels
+        float x, y, width, height;
+        //Texture coordinates in the page
+        float u0, v0, u1, v1;
+        uint32_t page;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Laid out text, cached by the font
+    /// \brief -
+    ///
+    ////////////////////////////////////////////////////////////////
+    struct TextLayout {
+        std::vector<TextLayoutGlyph> glyphs;
+        float width, height;
+        uint64_t lastUsed;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Counters of a font
+    /// \brief -
+    ///
+    ////////////////////////////////////////////////////////////////
+    struct FontStats {
+        uint32_t cachedGlyphs;
+        uint32_t cachedLayouts;
+        uint64_t layoutHits;
+        uint64_t layoutMisses;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Glyph cache atlas and layout cache of a glyph source.
+    /// \brief Glyphs are rasterized and packed into atlas pages the first time they are used.
+    /// \brief -
+    ///
+    ////////////////////////////////////////////////////////////////
+    class Font {
+    public:
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Creates an empty font, the source has to outlive the font.
+        /// \brief -
+        ///
+        /// \param source The source glyphs are rasterized by.
+        /// \param type How glyphs are stored in the atlas.
+        /// \param pageSize The edge length of an atlas page in pixels.
+        /// \param sdfSpread The distance in pixels a SDF covers outside and inside of the glyph outlines.
+        ///
+        ////////////////////////////////////////////////////////////////
+        Font(GlyphSource &source, FontType type = FontType::Bitmap, uint32_t pageSize = 1024, uint32_t sdfSpread = 4);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Gets a glyph, rasterizes and packs it on first use.
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        const FontGlyph &getGlyph(uint32_t codepoint);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Lays out an UTF-8 text, reuses the layout of an unchanged text.
+        /// \brief -
+        ///
+        /// \return TextLayout
+        /// \return The layout, valid until collectLayouts removes it
+        ///
+        ////////////////////////////////////////////////////////////////
+        const TextLayout &layout(const std::string &text);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Starts a new frame and removes layouts unused for maxUnusedFrames frames.
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void collectLayouts(uint32_t maxUnusedFrames);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Gets the changed area of a page since the last clearDirtyRect.
+        /// \brief -
+        ///
+        /// \return bool
+        /// \return FALSE if the page did not change
+        ///
+        ////////////////////////////////////////////////////////////////
+        bool getDirtyRect(uint32_t page, uint32_t &x, uint32_t &y, uint32_t &width, uint32_t &height) const;
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Marks the top rows of the changed area of a page as uploaded.
+        /// \brief -
+        ///
+        /// \param page The page.
+        /// \param rows The number of uploaded rows, the whole area by default.
+        ///
+        ////////////////////////////////////////////////////////////////
+        void clearDirtyRect(uint32_t page, uint32_t rows = UINT32_MAX);
+
+        //Getters
+        FontType getType() const { return type; }
+        uint32_t getSdfSpread() const { return sdfSpread; }
+        uint32_t getPageSize() const { return pageSize; }
+        uint32_t getPageCount() const { return uint32_t(pages.size()); }
+        //Pixels of a page, one byte per pixel
+        const uint8_t *getPagePixels(uint32_t page) const { return pages.at(page).pixels.data(); }
+        float getLineHeight() const { return source.getLineHeight(); }
+        const FontStats &getStats() const { return stats; }
+
+    private:
+        struct Page {
+            std::vector<uint8_t> pixels;
+            //Open shelf of the shelf packer
+            uint32_t shelfY, shelfHeight, cursorX;
+            //Changed area, empty if dirtyX0 >= dirtyX1
+            uint32_t dirtyX0, dirtyY0, dirtyX1, dirtyY1;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Finds room for a rectangle, opens new shelves and pages as needed
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void pack(uint32_t width, uint32_t height, uint32_t &page, uint32_t &x, uint32_t &y);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Converts a coverage bitmap to a signed distance field padded by sdfSpread
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void generateSdf(GlyphBitmap &glyph) const;
+
+        GlyphSource &source;
+        FontType type;
+        uint32_t pageSize;
+        uint32_t sdfSpread;
+
+        std::vector<Page> pages;
+        std::unordered_map<uint32_t, FontGlyph> glyphs;
+        std::unordered_map<std::string, TextLayout> layouts;
+        uint64_t frame = 0;
+
+        FontStats stats{};
+    };
+}
+
+#endif //PPGL_FONT_H
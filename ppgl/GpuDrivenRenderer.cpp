@@ -0,0 +1,393 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include "GpuDrivenRenderer.h"
+
+/*
+ * SPIR-V of the culling shader, generated at build time from shaders/
+ */
+static const uint32_t gpuCullCode[] =
+#include "shaders/gpu_cull.comp.inc"
+;
+
+//Size of a VkDrawIndexedIndirectCommand
+static const VkDeviceSize drawCommandSize = sizeof(VkDrawIndexedIndirectCommand);
+
+//Tests a bounding sphere against the frustum planes
+static bool sphereInFrustum(const float planes[6][4], const PPGL::GpuDrawObject &object) {
+    for (int i = 0; i < 6; ++i) {
+        if(planes[i][0] * object.center[0] + planes[i][1] * object.center[1] + planes[i][2] * object.center[2] +
+           planes[i][3] < -object.radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+PPGL::GpuDrivenRenderer::GpuDrivenRenderer(const Vulkan &vulkan, uint32_t maxObjects, uint32_t framesInFlight) :
+        vulkan (vulkan), vk (vulkan.getDispatch()), device (vulkan.getDevice()), maxObjects (maxObjects),
+        framesInFlight (framesInFlight)
+{
+    VkResult errorDescription;
+
+    //The object id is the firstInstance of its draw, indirect draws need the feature for it
+    if(!vulkan.getEnabledFeatures().drawIndirectFirstInstance) {
+        std::cout << PPGL::Exception("GpuDrivenRenderer.cpp", __LINE__, "GpuDrivenRenderer()",
+                                     "drawIndirectFirstInstance is not enabled");
+        throw std::runtime_error("GPU driven rendering needs the drawIndirectFirstInstance feature!");
+    }
+
+    //A GPU written draw count can exceed maxDrawIndirectCount of 1 without multiDrawIndirect
+    drawCountEnabled = vulkan.hasDrawIndirectCount() && vulkan.getEnabledFeatures().multiDrawIndirect;
+
+    /*
+     * Create buffers
+     */
+    vulkan.createBuffer(sizeof(GpuDrawObject) * maxObjects,
+                        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, objectBuffer, objectMemory);
+    //Changed objects are written here and copied to the object buffer during recordCulling
+    vulkan.createBuffer(sizeof(GpuDrawObject) * maxObjects * framesInFlight, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                        stagingBuffer, stagingMemory);
+    vulkan.createBuffer(drawCommandSize * maxObjects,
+                        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, drawBuffer, drawMemory);
+    vulkan.createBuffer(sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                        VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                        countBuffer, countMemory);
+    errorDescription = vk.vkMapMemory(device, stagingMemory, 0, VK_WHOLE_SIZE, 0,
+                                      reinterpret_cast<void **>(&mappedStaging));
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("GpuDrivenRenderer.cpp", __LINE__, "vkMapMemory()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to map culling staging memory!");
+    }
+
+    /*
+     * Create descriptor set: objects, draw commands and draw count
+     */
+    VkDescriptorSetLayoutBinding bindings[3];
+    for (uint32_t i = 0; i < 3; ++i) {
+        bindings[i] = {i, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr};
+    }
+    VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = {
+            VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            nullptr,
+            0,
+            3,
+            bindings
+    };
+    errorDescription = vk.vkCreateDescriptorSetLayout(device, &descriptorSetLayoutCreateInfo, vulkan.getAllocator(),
+                                                      &descriptorSetLayout);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("GpuDrivenRenderer.cpp", __LINE__, "vkCreateDescriptorSetLayout()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create culling descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3};
+    VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {
+            VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            nullptr,
+            0,
+            1,
+            1,
+            &poolSize
+    };
+    errorDescription = vk.vkCreateDescriptorPool(device, &descriptorPoolCreateInfo, vulkan.getAllocator(),
+                                                 &descriptorPool);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("GpuDrivenRenderer.cpp", __LINE__, "vkCreateDescriptorPool()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create culling descriptor pool!");
+    }
+
+    VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {
+            VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            nullptr,
+            descriptorPool,
+            1,
+            &descriptorSetLayout
+    };
+    errorDescription = vk.vkAllocateDescriptorSets(device, &descriptorSetAllocateInfo, &descriptorSet);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("GpuDrivenRenderer.cpp", __LINE__, "vkAllocateDescriptorSets()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to allocate culling descriptor set!");
+    }
+
+    VkDescriptorBufferInfo bufferInfos[3] = {
+            {objectBuffer, 0, VK_WHOLE_SIZE},
+            {drawBuffer, 0, VK_WHOLE_SIZE},
+            {countBuffer, 0, VK_WHOLE_SIZE}
+    };
+    VkWriteDescriptorSet writes[3];
+    for (uint32_t i = 0; i < 3; ++i) {
+        writes[i] = {
+                VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                nullptr,
+                descriptorSet,
+                i,
+                0,
+                1,
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                nullptr,
+                &bufferInfos[i],
+                nullptr
+        };
+    }
+    vk.vkUpdateDescriptorSets(device, 3, writes, 0, nullptr);
+
+    /*
+     * Create culling pipeline
+     */
+    VkPushConstantRange pushConstantRange = {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullConstants)};
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {
+            VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            nullptr,
+            0,
+            1,
+            &descriptorSetLayout,
+            1,
+            &pushConstantRange
+    };
+    errorDescription = vk.vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, vulkan.getAllocator(),
+                                                 &pipelineLayout);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("GpuDrivenRenderer.cpp", __LINE__, "vkCreatePipelineLayout()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create culling pipeline layout!");
+    }
+
+    VkShaderModule shaderModule = vulkan.createShaderModule(gpuCullCode, sizeof(gpuCullCode));
+    VkComputePipelineCreateInfo computePipelineCreateInfo = {
+            VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+            nullptr,
+            0,
+            {
+                    VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                    nullptr,
+                    0,
+                    VK_SHADER_STAGE_COMPUTE_BIT,
+                    shaderModule,
+                    "main",
+                    nullptr
+            },
+            pipelineLayout,
+            VK_NULL_HANDLE,
+            -1
+    };
+    errorDescription = vk.vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &computePipelineCreateInfo,
+                                                   vulkan.getAllocator(), &cullPipeline);
+    vk.vkDestroyShaderModule(device, shaderModule, vulkan.getAllocator());
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("GpuDrivenRenderer.cpp", __LINE__, "vkCreateComputePipelines()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create culling pipeline!");
+    }
+
+    //Without a GPU written count every object keeps its own draw
+    constants.compact = drawCountEnabled ? 1 : 0;
+}
+
+uint32_t PPGL::GpuDrivenRenderer::addObject(const GpuDrawObject &object) {
+    if(objects.size() >= maxObjects) {
+        std::cout << PPGL::Exception("GpuDrivenRenderer.cpp", __LINE__, "addObject()", "Too many objects");
+        throw std::runtime_error("Too many GPU driven objects!");
+    }
+
+    objects.push_back(object);
+    uint32_t id = uint32_t(objects.size() - 1);
+    //Marks the new object for upload
+    setObject(id, object);
+    return id;
+}
+
+void PPGL::GpuDrivenRenderer::setObject(uint32_t id, const GpuDrawObject &object) {
+    objects.at(id) = object;
+
+    //Grow the range of objects to upload
+    if(dirtyBegin == dirtyEnd) {
+        dirtyBegin = id;
+        dirtyEnd = id + 1;
+    } else {
+        dirtyBegin = std::min(dirtyBegin, id);
+        dirtyEnd = std::max(dirtyEnd, id + 1);
+    }
+}
+
+void PPGL::GpuDrivenRenderer::setFrustum(const float viewProjection[16]) {
+    //Rows of the column major matrix
+    float rows[4][4];
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            rows[row][column] = viewProjection[column * 4 + row];
+        }
+    }
+
+    //Left, right, bottom, top, near and far plane, near is z >= 0 for a depth range of 0 to 1
+    for (int i = 0; i < 4; ++i) {
+        constants.planes[0][i] = rows[3][i] + rows[0][i];
+        constants.planes[1][i] = rows[3][i] - rows[0][i];
+        constants.planes[2][i] = rows[3][i] + rows[1][i];
+        constants.planes[3][i] = rows[3][i] - rows[1][i];
+        constants.planes[4][i] = rows[2][i];
+        constants.planes[5][i] = rows[3][i] - rows[2][i];
+    }
+
+    //Normalize, so distances can be compared to the sphere radius
+    for (auto &plane : constants.planes) {
+        float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if(length > 0.0f) {
+            for (float &value : plane) {
+                value /= length;
+            }
+        }
+    }
+}
+
+void PPGL::GpuDrivenRenderer::recordCulling(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+    if(frameIndex >= framesInFlight) {
+        std::cout << PPGL::Exception("GpuDrivenRenderer.cpp", __LINE__, "recordCulling()", "Invalid frame index");
+        throw std::runtime_error("Invalid frame index!");
+    }
+
+    //The draws of the previous frame have to be read before they get overwritten
+    vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                            VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                            0, nullptr, 0, nullptr, 0, nullptr);
+
+    //Upload the changed objects through this frame's staging region
+    if(dirtyBegin != dirtyEnd) {
+        VkDeviceSize regionOffset = VkDeviceSize(frameIndex) * maxObjects * sizeof(GpuDrawObject);
+        std::memcpy(mappedStaging + size_t(frameIndex) * maxObjects + dirtyBegin, objects.data() + dirtyBegin,
+                    (dirtyEnd - dirtyBegin) * sizeof(GpuDrawObject));
+
+        VkBufferCopy bufferCopy = {
+                regionOffset + dirtyBegin * sizeof(GpuDrawObject),
+                dirtyBegin * sizeof(GpuDrawObject),
+                (dirtyEnd - dirtyBegin) * sizeof(GpuDrawObject)
+        };
+        vk.vkCmdCopyBuffer(commandBuffer, stagingBuffer, objectBuffer, 1, &bufferCopy);
+        dirtyBegin = dirtyEnd = 0;
+    }
+
+    //Reset the draw count
+    vk.vkCmdFillBuffer(commandBuffer, countBuffer, 0, sizeof(uint32_t), 0);
+
+    VkMemoryBarrier uploadBarrier = {
+            VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            nullptr,
+            VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+    };
+    vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                            1, &uploadBarrier, 0, nullptr, 0, nullptr);
+
+    //Cull and write the draws
+    constants.objectCount = uint32_t(objects.size());
+    if(constants.objectCount > 0) {
+        vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipeline);
+        vk.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1,
+                                   &descriptorSet, 0, nullptr);
+        vk.vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                              sizeof(CullConstants), &constants);
+        vk.vkCmdDispatch(commandBuffer, (constants.objectCount + 63) / 64, 1, 1);
+    }
+
+    VkMemoryBarrier drawBarrier = {
+            VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            nullptr,
+            VK_ACCESS_SHADER_WRITE_BIT,
+            VK_ACCESS_INDIRECT_COMMAND_READ_BIT
+    };
+    vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                            0, 1, &drawBarrier, 0, nullptr, 0, nullptr);
+
+    stats.objectCount = constants.objectCount;
+}
+
+void PPGL::GpuDrivenRenderer::recordDraw(VkCommandBuffer commandBuffer) {
+    auto start = std::chrono::steady_clock::now();
+    uint32_t objectCount = uint32_t(objects.size());
+
+    if(objectCount == 0) {
+        stats.drawRecordTime = 0.0;
+        return;
+    }
+
+    if(drawCountEnabled) {
+        //One call, the GPU decides how many of the compacted draws are executed
+        uint32_t maxDrawCount = std::min(objectCount,
+                                         vulkan.getPhysicalDeviceProperties().limits.maxDrawIndirectCount);
+        vk.vkCmdDrawIndexedIndirectCountKHR(commandBuffer, drawBuffer, 0, countBuffer, 0, maxDrawCount,
+                                            uint32_t(drawCommandSize));
+    } else {
+        //Every object has a draw, culled ones without instances
+        uint32_t maxDrawCount = vulkan.getEnabledFeatures().multiDrawIndirect ?
+                                vulkan.getPhysicalDeviceProperties().limits.maxDrawIndirectCount : 1;
+        for (uint32_t first = 0; first < objectCount; first += maxDrawCount) {
+            vk.vkCmdDrawIndexedIndirect(commandBuffer, drawBuffer, first * drawCommandSize,
+                                        std::min(maxDrawCount, objectCount - first), uint32_t(drawCommandSize));
+        }
+    }
+
+    stats.drawRecordTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void PPGL::GpuDrivenRenderer::recordDrawClassic(VkCommandBuffer commandBuffer) {
+    auto start = std::chrono::steady_clock::now();
+
+    stats.classicDraws = 0;
+    for (uint32_t id = 0; id < objects.size(); ++id) {
+        const GpuDrawObject &object = objects[id];
+        if(object.indexCount == 0 || !sphereInFrustum(constants.planes, object)) {
+            continue;
+        }
+
+        vk.vkCmdDrawIndexed(commandBuffer, object.indexCount, 1, object.firstIndex, object.vertexOffset, id);
+        ++stats.classicDraws;
+    }
+
+    stats.classicRecordTime =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+PPGL::GpuDrivenRenderer::~GpuDrivenRenderer() {
+    vk.vkDestroyPipeline(device, cullPipeline, vulkan.getAllocator());
+    vk.vkDestroyPipelineLayout(device, pipelineLayout, vulkan.getAllocator());
+    vk.vkDestroyDescriptorPool(device, descriptorPool, vulkan.getAllocator());
+    vk.vkDestroyDescriptorSetLayout(device, descriptorSetLayout, vulkan.getAllocator());
+
+    vulkan.destroyBuffer(objectBuffer, objectMemory);
+    vulkan.destroyBuffer(stagingBuffer, stagingMemory);
+    vulkan.destroyBuffer(drawBuffer, drawMemory);
+    vulkan.destroyBuffer(countBuffer, countMemory);
+}
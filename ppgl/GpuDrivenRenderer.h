@@ -0,0 +1,222 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+#ifndef PPGL_GPUDRIVENRENDERER_H
+#define PPGL_GPUDRIVENRENDERER_H
+
+/*
+ * Headers
+ */
+#include <vector>
+
+#include "Vulkan.h"
+
+namespace PPGL {
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Bounds and indexed draw of one object
+    /// \brief -
+    ///
+    /// \param center The center of the bounding sphere in world space.
+    /// \param radius The radius of the bounding sphere, the object is never drawn if indexCount is 0.
+    /// \param indexCount The number of indices to draw.
+    /// \param firstIndex The first index in the bound index buffer.
+    /// \param vertexOffset The value added to the indices.
+    ///
+    ////////////////////////////////////////////////////////////////
+    struct GpuDrawObject {
+        float center[3];
+        float radius;
+        uint32_t indexCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+        uint32_t padding;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Statistics of the GpuDrivenRenderer
+    /// \brief -
+    ///
+    /// \param objectCount The number of objects.
+    /// \param drawRecordTime The CPU time of the last recordDraw in milliseconds.
+    /// \param classicRecordTime The CPU time of the last recordDrawClassic in milliseconds.
+    /// \param classicDraws The number of draws recorded by the last recordDrawClassic.
+    ///
+    ////////////////////////////////////////////////////////////////
+    struct GpuDrivenStats {
+        uint32_t objectCount;
+        double drawRecordTime;
+        double classicRecordTime;
+        uint32_t classicDraws;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Draws many objects with few commands. Object bounds and draws live in
+    /// \brief device buffers, a compute pass frustum culls them and compacts the
+    /// \brief visible draws, which are drawn with vkCmdDrawIndexedIndirectCount.
+    /// \brief Falls back to vkCmdDrawIndexedIndirect if VK_KHR_draw_indirect_count
+    /// \brief or the multiDrawIndirect feature is missing.
+    /// \brief -
+    ///
+    ////////////////////////////////////////////////////////////////
+    class GpuDrivenRenderer {
+    public:
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Creates the object and draw buffers and the culling pipeline.
+        /// \brief Vulkan::init has to be called before and has to enable the
+        /// \brief drawIndirectFirstInstance feature, throws otherwise.
+        /// \brief -
+        ///
+        /// \param vulkan The initialized Vulkan instance.
+        /// \param maxObjects The maximum number of objects.
+        /// \param framesInFlight The number of frames recorded before the first one finished.
+        ///
+        ////////////////////////////////////////////////////////////////
+        GpuDrivenRenderer(const Vulkan &vulkan, uint32_t maxObjects, uint32_t framesInFlight = 2);
+        ~GpuDrivenRenderer();
+
+        GpuDrivenRenderer(const GpuDrivenRenderer &) = delete;
+        GpuDrivenRenderer &operator = (const GpuDrivenRenderer &) = delete;
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Adds an object.
+        /// \brief -
+        ///
+        /// \return uint32_t
+        /// \return The id of the object, it is the firstInstance of its draw
+        ///
+        ////////////////////////////////////////////////////////////////
+        uint32_t addObject(const GpuDrawObject &object);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Overwrites an object, set indexCount to 0 to hide it.
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void setObject(uint32_t id, const GpuDrawObject &object);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Sets the frustum objects are culled against.
+        /// \brief -
+        ///
+        /// \param viewProjection The column major view projection matrix, with a depth range of 0 to 1.
+        ///
+        ////////////////////////////////////////////////////////////////
+        void setFrustum(const float viewProjection[16]);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Records the upload of changed objects and the culling pass.
+        /// \brief Has to be recorded outside of a render pass, before recordDraw.
+        /// \brief -
+        ///
+        /// \param commandBuffer A graphics command buffer.
+        /// \param frameIndex The index of the frame in flight, 0 to framesInFlight - 1.
+        ///
+        ////////////////////////////////////////////////////////////////
+        void recordCulling(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Records the indirect draws of the visible objects.
+        /// \brief The pipeline, index and vertex buffers have to be bound.
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void recordDraw(VkCommandBuffer commandBuffer);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Culls on the CPU and records one vkCmdDrawIndexed per visible object.
+        /// \brief The classic path, to compare against recordDraw.
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void recordDrawClassic(VkCommandBuffer commandBuffer);
+
+        //Getters
+        bool usesDrawIndirectCount() const { return drawCountEnabled; }
+        const GpuDrivenStats &getStats() const { return stats; }
+
+    private:
+        //Mirrors the push constants of the culling shader
+        struct CullConstants {
+            float planes[6][4];
+            uint32_t objectCount;
+            uint32_t compact;
+        };
+
+        const Vulkan &vulkan;
+        const VulkanDispatch &vk;
+        VkDevice device;
+        uint32_t maxObjects;
+        uint32_t framesInFlight;
+        //True if draws are compacted and drawn with vkCmdDrawIndexedIndirectCount
+        bool drawCountEnabled;
+
+        //Objects on the CPU, the range [dirtyBegin, dirtyEnd) is not uploaded yet
+        std::vector<GpuDrawObject> objects;
+        uint32_t dirtyBegin = 0;
+        uint32_t dirtyEnd = 0;
+
+        CullConstants constants{};
+
+        //Buffers
+        VkBuffer objectBuffer, stagingBuffer, drawBuffer, countBuffer;
+        VkDeviceMemory objectMemory, stagingMemory, drawMemory, countMemory;
+        //One region of maxObjects objects per frame in flight
+        GpuDrawObject *mappedStaging;
+
+        //Descriptors
+        VkDescriptorSetLayout descriptorSetLayout;
+        VkDescriptorPool descriptorPool;
+        VkDescriptorSet descriptorSet;
+
+        //Pipeline
+        VkPipelineLayout pipelineLayout;
+        VkPipeline cullPipeline;
+
+        GpuDrivenStats stats{};
+    };
+}
+
+#endif //PPGL_GPUDRIVENRENDERER_H
@@ -0,0 +1,711 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "ParticleSystem.h"
+
+/*
+ * SPIR-V of the particle shaders, generated at build time from shaders/
+ */
+static const uint32_t particleResetCode[] =
+#include "shaders/particle_reset.comp.inc"
+;
+static const uint32_t particleEmitCode[] =
+#include "shaders/particle_emit.comp.inc"
+;
+static const uint32_t particleDispatchCode[] =
+#include "shaders/particle_dispatch.comp.inc"
+;
+static const uint32_t particleSimulateCode[] =
+#include "shaders/particle_simulate.comp.inc"
+;
+static const uint32_t particleFinalizeCode[] =
+#include "shaders/particle_finalize.comp.inc"
+;
+static const uint32_t particleVertexCode[] =
+#include "shaders/particle.vert.inc"
+;
+static const uint32_t particleFragmentCode[] =
+#include "shaders/particle.frag.inc"
+;
+
+//Size of a particle in the particle buffer
+static const VkDeviceSize particleSize = 48;
+
+//Mirrors the push constants of the particle render shaders
+struct ParticleRenderConstants {
+    float viewProjection[16];
+    uint32_t list;
+    uint32_t maxParticles;
+    float size;
+};
+
+PPGL::ParticleSystem::ParticleSystem(const Vulkan &vulkan, uint32_t maxParticles) :
+        vulkan (vulkan), vk (vulkan.getDispatch()), device (vulkan.getDevice()), maxParticles (maxParticles)
+{
+    VkResult errorDescription;
+
+    /*
+     * Create buffers
+     */
+    vulkan.createBuffer(particleSize * maxParticles, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, particleBuffer, particleMemory);
+    vulkan.createBuffer(sizeof(uint32_t) * maxParticles, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, deadListBuffer, deadListMemory);
+    //Two alive lists, one read and one written per step
+    vulkan.createBuffer(2 * sizeof(uint32_t) * maxParticles, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, aliveListBuffer, aliveListMemory);
+    vulkan.createBuffer(counterSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                        VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                        counterBuffer, counterMemory);
+    //Emitters and the counter readback are written and read by the CPU every step
+    vulkan.createBuffer(sizeof(GpuEmitter) * maxEmitters, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                        emitterBuffer, emitterMemory);
+    vulkan.createBuffer(counterSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                        readbackBuffer, readbackMemory);
+    errorDescription = vk.vkMapMemory(device, emitterMemory, 0, VK_WHOLE_SIZE, 0,
+                                      reinterpret_cast<void **>(&mappedEmitters));
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("ParticleSystem.cpp", __LINE__, "vkMapMemory()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to map particle emitter memory!");
+    }
+    errorDescription = vk.vkMapMemory(device, readbackMemory, 0, VK_WHOLE_SIZE, 0,
+                                      reinterpret_cast<void **>(&mappedReadback));
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("ParticleSystem.cpp", __LINE__, "vkMapMemory()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to map particle readback memory!");
+    }
+
+    createDescriptorSet();
+
+    /*
+     * Create compute pipelines
+     */
+    VkPushConstantRange pushConstantRange = {
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            0,
+            sizeof(ComputeConstants)
+    };
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {
+            VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            nullptr,
+            0,
+            1,
+            &descriptorSetLayout,
+            1,
+            &pushConstantRange
+    };
+    errorDescription = vk.vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, vulkan.getAllocator(),
+                                                 &computePipelineLayout);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("ParticleSystem.cpp", __LINE__, "vkCreatePipelineLayout()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create particle pipeline layout!");
+    }
+
+    resetPipeline = createComputePipeline(particleResetCode, sizeof(particleResetCode));
+    emitPipeline = createComputePipeline(particleEmitCode, sizeof(particleEmitCode));
+    dispatchPipeline = createComputePipeline(particleDispatchCode, sizeof(particleDispatchCode));
+    simulatePipeline = createComputePipeline(particleSimulateCode, sizeof(particleSimulateCode));
+    finalizePipeline = createComputePipeline(particleFinalizeCode, sizeof(particleFinalizeCode));
+
+    /*
+     * Create command buffer and fence for the compute queue
+     */
+    VkCommandPoolCreateInfo commandPoolCreateInfo = {
+            VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            nullptr,
+            VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+            vulkan.getComputeQueueFamilyIndex()
+    };
+    errorDescription = vk.vkCreateCommandPool(device, &commandPoolCreateInfo, vulkan.getAllocator(), &commandPool);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("ParticleSystem.cpp", __LINE__, "vkCreateCommandPool()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create particle command pool!");
+    }
+
+    VkCommandBufferAllocateInfo commandBufferAllocateInfo = {
+            VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            nullptr,
+            commandPool,
+            VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            1
+    };
+    errorDescription = vk.vkAllocateCommandBuffers(device, &commandBufferAllocateInfo, &commandBuffer);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("ParticleSystem.cpp", __LINE__, "vkAllocateCommandBuffers()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to allocate particle command buffer!");
+    }
+
+    VkFenceCreateInfo fenceCreateInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, nullptr, 0};
+    errorDescription = vk.vkCreateFence(device, &fenceCreateInfo, vulkan.getAllocator(), &fence);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("ParticleSystem.cpp", __LINE__, "vkCreateFence()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create particle fence!");
+    }
+
+    /*
+     * Create timestamp query pool, if the compute queue family supports timestamps
+     */
+    uint32_t queueFamilyCount = 0;
+    vk.vkGetPhysicalDeviceQueueFamilyProperties(vulkan.getPhysicalDevice(), &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vk.vkGetPhysicalDeviceQueueFamilyProperties(vulkan.getPhysicalDevice(), &queueFamilyCount, queueFamilies.data());
+    if(queueFamilies[vulkan.getComputeQueueFamilyIndex()].timestampValidBits != 0) {
+        VkQueryPoolCreateInfo queryPoolCreateInfo = {
+                VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                nullptr,
+                0,
+                VK_QUERY_TYPE_TIMESTAMP,
+                2,
+                0
+        };
+        errorDescription = vk.vkCreateQueryPool(device, &queryPoolCreateInfo, vulkan.getAllocator(), &queryPool);
+        if(errorDescription != VK_SUCCESS) {
+            std::cout << PPGL::Exception("ParticleSystem.cpp", __LINE__, "vkCreateQueryPool()",
+                                         ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+            throw std::runtime_error("Failed to create particle query pool!");
+        }
+    }
+
+    constants.maxParticles = maxParticles;
+    reset();
+}
+
+void PPGL::ParticleSystem::createDescriptorSet() {
+    VkResult errorDescription;
+
+    //Particles, dead list, alive lists, counters and emitters
+    VkDescriptorSetLayoutBinding bindings[5];
+    for (uint32_t i = 0; i < 5; ++i) {
+        bindings[i] = {
+                i,
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                1,
+                VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT,
+                nullptr
+        };
+    }
+
+    VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = {
+            VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            nullptr,
+            0,
+            5,
+            bindings
+    };
+    errorDescription = vk.vkCreateDescriptorSetLayout(device, &descriptorSetLayoutCreateInfo, vulkan.getAllocator(),
+                                                      &descriptorSetLayout);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("ParticleSystem.cpp", __LINE__, "vkCreateDescriptorSetLayout()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create particle descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 5};
+    VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {
+            VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            nullptr,
+            0,
+            1,
+            1,
+            &poolSize
+    };
+    errorDescription = vk.vkCreateDescriptorPool(device, &descriptorPoolCreateInfo, vulkan.getAllocator(),
+                                                 &descriptorPool);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("ParticleSystem.cpp", __LINE__, "vkCreateDescriptorPool()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create particle descriptor pool!");
+    }
+
+    VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {
+            VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            nullptr,
+            descriptorPool,
+            1,
+            &descriptorSetLayout
+    };
+    errorDescription = vk.vkAllocateDescriptorSets(device, &descriptorSetAllocateInfo, &descriptorSet);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("ParticleSystem.cpp", __LINE__, "vkAllocateDescriptorSets()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to allocate particle descriptor set!");
+    }
+
+    //Point the bindings to the buffers
+    VkDescriptorBufferInfo bufferInfos[5] = {
+            {particleBuffer, 0, VK_WHOLE_SIZE},
+            {deadListBuffer, 0, VK_WHOLE_SIZE},
+            {aliveListBuffer, 0, VK_WHOLE_SIZE},
+            {counterBuffer, 0, VK_WHOLE_SIZE},
+            {emitterBuffer, 0, VK_WHOLE_SIZE}
+    };
+    VkWriteDescriptorSet writes[5];
+    for (uint32_t i = 0; i < 5; ++i) {
+        writes[i] = {
+                VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                nullptr,
+                descriptorSet,
+                i,
+                0,
+                1,
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                nullptr,
+                &bufferInfos[i],
+                nullptr
+        };
+    }
+    vk.vkUpdateDescriptorSets(device, 5, writes, 0, nullptr);
+}
+
+VkPipeline PPGL::ParticleSystem::createComputePipeline(const uint32_t *code, size_t size) {
+    VkShaderModule shaderModule = vulkan.createShaderModule(code, size);
+
+    VkComputePipelineCreateInfo computePipelineCreateInfo = {
+            VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+            nullptr,
+            0,
+            {
+                    VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                    nullptr,
+                    0,
+                    VK_SHADER_STAGE_COMPUTE_BIT,
+                    shaderModule,
+                    "main",
+                    nullptr
+            },
+            computePipelineLayout,
+            VK_NULL_HANDLE,
+            -1
+    };
+
+    VkPipeline pipeline;
+    VkResult errorDescription = vk.vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &computePipelineCreateInfo,
+                                                            vulkan.getAllocator(), &pipeline);
+    //Module is not needed after pipeline creation
+    vk.vkDestroyShaderModule(device, shaderModule, vulkan.getAllocator());
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("ParticleSystem.cpp", __LINE__, "vkCreateComputePipelines()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create particle compute pipeline!");
+    }
+
+    return pipeline;
+}
+
+uint32_t PPGL::ParticleSystem::addEmitter(const ParticleEmitter &emitter) {
+    if(emitters.size() >= maxEmitters) {
+        std::cout << PPGL::Exception("ParticleSystem.cpp", __LINE__, "addEmitter()", "Too many emitters");
+        throw std::runtime_error("Too many particle emitters!");
+    }
+
+    emitters.push_back(emitter);
+    emitterRemainders.push_back(0.0f);
+    return uint32_t(emitters.size() - 1);
+}
+
+void PPGL::ParticleSystem::setEmitter(uint32_t id, const ParticleEmitter &emitter) {
+    emitters.at(id) = emitter;
+}
+
+void PPGL::ParticleSystem::setForces(float gravityX, float gravityY, float gravityZ, float drag) {
+    constants.gravityDrag[0] = gravityX;
+    constants.gravityDrag[1] = gravityY;
+    constants.gravityDrag[2] = gravityZ;
+    constants.gravityDrag[3] = drag;
+}
+
+void PPGL::ParticleSystem::computeBarrier(VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+    VkMemoryBarrier memoryBarrier = {
+            VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            nullptr,
+            VK_ACCESS_SHADER_WRITE_BIT,
+            dstAccess
+    };
+    vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, dstStage, 0,
+                            1, &memoryBarrier, 0, nullptr, 0, nullptr);
+}
+
+void PPGL::ParticleSystem::waitForSimulation() {
+    if(!submitted) {
+        return;
+    }
+
+    vk.vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
+    vk.vkResetFences(device, 1, &fence);
+    submitted = false;
+
+    //Counters: dead count, alive count of both lists, current got flipped after the step
+    stats.aliveParticles = mappedReadback[1 + current];
+
+    if(queryPool != VK_NULL_HANDLE) {
+        uint64_t timestamps[2];
+        if(vk.vkGetQueryPoolResults(device, queryPool, 0, 2, sizeof(timestamps), timestamps, sizeof(uint64_t),
+                                    VK_QUERY_RESULT_64_BIT) == VK_SUCCESS) {
+            double nanoseconds = double(timestamps[1] - timestamps[0]) *
+                                 vulkan.getPhysicalDeviceProperties().limits.timestampPeriod;
+            stats.simulationTime = nanoseconds / 1000000.0;
+            stats.nanosecondsPerParticle = nanoseconds / (stats.aliveParticles > 0 ? stats.aliveParticles : 1);
+        }
+    }
+}
+
+void PPGL::ParticleSystem::reset() {
+    waitForSimulation();
+
+    VkCommandBufferBeginInfo beginInfo = {
+            VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            nullptr,
+            VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+            nullptr
+    };
+    vk.vkResetCommandBuffer(commandBuffer, 0);
+    vk.vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+    vk.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computePipelineLayout, 0, 1,
+                               &descriptorSet, 0, nullptr);
+    vk.vkCmdPushConstants(commandBuffer, computePipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                          sizeof(ComputeConstants), &constants);
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, resetPipeline);
+    vk.vkCmdDispatch(commandBuffer, (maxParticles + 255) / 256, 1, 1);
+
+    vk.vkEndCommandBuffer(commandBuffer);
+
+    VkSubmitInfo submitInfo = {
+            VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            nullptr,
+            0,
+            nullptr,
+            nullptr,
+            1,
+            &commandBuffer,
+            0,
+            nullptr
+    };
+    vk.vkQueueSubmit(vulkan.getComputeQueue(), 1, &submitInfo, fence);
+    vk.vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
+    vk.vkResetFences(device, 1, &fence);
+
+    current = 0;
+    std::fill(emitterRemainders.begin(), emitterRemainders.end(), 0.0f);
+    stats = {};
+}
+
+void PPGL::ParticleSystem::simulate(float deltaTime, VkSemaphore waitSemaphore, VkSemaphore signalSemaphore) {
+    VkResult errorDescription;
+
+    //The emitter buffer and command buffer are reused, so the last step has to be finished
+    waitForSimulation();
+
+    /*
+     * Distribute this step's emissions over the emitters
+     */
+    uint32_t emitTotal = 0;
+    for (size_t i = 0; i < emitters.size(); ++i) {
+        const ParticleEmitter &emitter = emitters[i];
+        emitterRemainders[i] += emitter.rate * deltaTime;
+        float count = std::floor(emitterRemainders[i]);
+        emitterRemainders[i] -= count;
+
+        //Never request more particles than the pool holds
+        uint32_t emitCount = uint32_t(std::min(count, float(maxParticles - emitTotal)));
+
+        GpuEmitter &gpuEmitter = mappedEmitters[i];
+        std::memcpy(gpuEmitter.positionLifetime, emitter.position, sizeof(emitter.position));
+        gpuEmitter.positionLifetime[3] = emitter.lifetime;
+        std::memcpy(gpuEmitter.velocitySpread, emitter.velocity, sizeof(emitter.velocity));
+        gpuEmitter.velocitySpread[3] = emitter.spread;
+        std::memcpy(gpuEmitter.color, emitter.color, sizeof(emitter.color));
+        gpuEmitter.emit[0] = emitTotal;
+        gpuEmitter.emit[1] = emitCount;
+        gpuEmitter.emit[2] = seed++ * 0x9E3779B9u;
+        gpuEmitter.emit[3] = 0;
+
+        emitTotal += emitCount;
+    }
+    stats.emittedParticles = emitTotal;
+
+    constants.deltaTime = deltaTime;
+    constants.current = current;
+    constants.emitTotal = emitTotal;
+    constants.emitterCount = uint32_t(emitters.size());
+
+    /*
+     * Record the step
+     */
+    VkCommandBufferBeginInfo beginInfo = {
+            VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            nullptr,
+            VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+            nullptr
+    };
+    vk.vkResetCommandBuffer(commandBuffer, 0);
+    vk.vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+    if(queryPool != VK_NULL_HANDLE) {
+        vk.vkCmdResetQueryPool(commandBuffer, queryPool, 0, 2);
+        vk.vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, 0);
+    }
+
+    vk.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computePipelineLayout, 0, 1,
+                               &descriptorSet, 0, nullptr);
+    vk.vkCmdPushConstants(commandBuffer, computePipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                          sizeof(ComputeConstants), &constants);
+
+    //Emit into the current alive list
+    if(emitTotal > 0) {
+        vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, emitPipeline);
+        vk.vkCmdDispatch(commandBuffer, (emitTotal + 63) / 64, 1, 1);
+        computeBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    }
+
+    //Size the simulation dispatch to the alive particles
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, dispatchPipeline);
+    vk.vkCmdDispatch(commandBuffer, 1, 1, 1);
+    computeBarrier(VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                   VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    //Simulate and compact the survivors into the next alive list
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, simulatePipeline);
+    vk.vkCmdDispatchIndirect(commandBuffer, counterBuffer, dispatchOffset);
+    computeBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    //Write the indirect draw of the survivors
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, finalizePipeline);
+    vk.vkCmdDispatch(commandBuffer, 1, 1, 1);
+    computeBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+
+    //Copy the counters back for the statistics
+    VkBufferCopy bufferCopy = {0, 0, counterSize};
+    vk.vkCmdCopyBuffer(commandBuffer, counterBuffer, readbackBuffer, 1, &bufferCopy);
+    VkMemoryBarrier hostBarrier = {
+            VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            nullptr,
+            VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_ACCESS_HOST_READ_BIT
+    };
+    vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0,
+                            1, &hostBarrier, 0, nullptr, 0, nullptr);
+
+    if(queryPool != VK_NULL_HANDLE) {
+        vk.vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, 1);
+    }
+
+    vk.vkEndCommandBuffer(commandBuffer);
+
+    /*
+     * Submit to the compute queue
+     */
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    VkSubmitInfo submitInfo = {
+            VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            nullptr,
+            waitSemaphore != VK_NULL_HANDLE ? 1u : 0u,
+            &waitSemaphore,
+            &waitStage,
+            1,
+            &commandBuffer,
+            signalSemaphore != VK_NULL_HANDLE ? 1u : 0u,
+            &signalSemaphore
+    };
+    errorDescription = vk.vkQueueSubmit(vulkan.getComputeQueue(), 1, &submitInfo, fence);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("ParticleSystem.cpp", __LINE__, "vkQueueSubmit()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to submit particle simulation!");
+    }
+    submitted = true;
+
+    //The survivors are in the other list now
+    current = 1 - current;
+}
+
+void PPGL::ParticleSystem::createRenderPipeline(VkRenderPass renderPass, uint32_t subpass) {
+    VkResult errorDescription;
+
+    VkPushConstantRange pushConstantRange = {
+            VK_SHADER_STAGE_VERTEX_BIT,
+            0,
+            sizeof(ParticleRenderConstants)
+    };
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {
+            VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            nullptr,
+            0,
+            1,
+            &descriptorSetLayout,
+            1,
+            &pushConstantRange
+    };
+    errorDescription = vk.vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, vulkan.getAllocator(),
+                                                 &renderPipelineLayout);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("ParticleSystem.cpp", __LINE__, "vkCreatePipelineLayout()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create particle render pipeline layout!");
+    }
+
+    VkShaderModule vertexModule = vulkan.createShaderModule(particleVertexCode, sizeof(particleVertexCode));
+    VkShaderModule fragmentModule = vulkan.createShaderModule(particleFragmentCode, sizeof(particleFragmentCode));
+    VkPipelineShaderStageCreateInfo stages[2] = {
+            {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, nullptr, 0, VK_SHADER_STAGE_VERTEX_BIT,
+             vertexModule, "main", nullptr},
+            {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, nullptr, 0, VK_SHADER_STAGE_FRAGMENT_BIT,
+             fragmentModule, "main", nullptr}
+    };
+
+    //Quads are generated from the vertex index, no vertex input
+    VkPipelineVertexInputStateCreateInfo vertexInputState = {
+            VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO, nullptr, 0, 0, nullptr, 0, nullptr
+    };
+    VkPipelineInputAssemblyStateCreateInfo inputAssemblyState = {
+            VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO, nullptr, 0,
+            VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE
+    };
+    VkPipelineViewportStateCreateInfo viewportState = {
+            VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO, nullptr, 0, 1, nullptr, 1, nullptr
+    };
+    VkPipelineRasterizationStateCreateInfo rasterizationState = {
+            VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO, nullptr, 0, VK_FALSE, VK_FALSE,
+            VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE, VK_FALSE, 0.0f, 0.0f, 0.0f, 1.0f
+    };
+    VkPipelineMultisampleStateCreateInfo multisampleState = {
+            VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO, nullptr, 0, VK_SAMPLE_COUNT_1_BIT, VK_FALSE,
+            0.0f, nullptr, VK_FALSE, VK_FALSE
+    };
+    //Particles are tested against but do not write depth
+    VkPipelineDepthStencilStateCreateInfo depthStencilState = {
+            VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO, nullptr, 0, VK_TRUE, VK_FALSE,
+            VK_COMPARE_OP_LESS_OR_EQUAL, VK_FALSE, VK_FALSE, {}, {}, 0.0f, 1.0f
+    };
+    //Additive blending, so particles do not need to be sorted
+    VkPipelineColorBlendAttachmentState colorBlendAttachment = {
+            VK_TRUE,
+            VK_BLEND_FACTOR_SRC_ALPHA, VK_BLEND_FACTOR_ONE, VK_BLEND_OP_ADD,
+            VK_BLEND_FACTOR_ZERO, VK_BLEND_FACTOR_ONE, VK_BLEND_OP_ADD,
+            VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+    };
+    VkPipelineColorBlendStateCreateInfo colorBlendState = {
+            VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO, nullptr, 0, VK_FALSE, VK_LOGIC_OP_COPY,
+            1, &colorBlendAttachment, {0.0f, 0.0f, 0.0f, 0.0f}
+    };
+    VkDynamicState dynamicStates[2] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState = {
+            VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO, nullptr, 0, 2, dynamicStates
+    };
+
+    VkGraphicsPipelineCreateInfo graphicsPipelineCreateInfo = {
+            VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+            nullptr,
+            0,
+            2,
+            stages,
+            &vertexInputState,
+            &inputAssemblyState,
+            nullptr,
+            &viewportState,
+            &rasterizationState,
+            &multisampleState,
+            &depthStencilState,
+            &colorBlendState,
+            &dynamicState,
+            renderPipelineLayout,
+            renderPass,
+            subpass,
+            VK_NULL_HANDLE,
+            -1
+    };
+    errorDescription = vk.vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &graphicsPipelineCreateInfo,
+                                                    vulkan.getAllocator(), &renderPipeline);
+    vk.vkDestroyShaderModule(device, vertexModule, vulkan.getAllocator());
+    vk.vkDestroyShaderModule(device, fragmentModule, vulkan.getAllocator());
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("ParticleSystem.cpp", __LINE__, "vkCreateGraphicsPipelines()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create particle render pipeline!");
+    }
+}
+
+void PPGL::ParticleSystem::recordDraw(VkCommandBuffer commandBuffer, const float viewProjection[16], float size) {
+    if(renderPipeline == VK_NULL_HANDLE) {
+        std::cout << PPGL::Exception("ParticleSystem.cpp", __LINE__, "recordDraw()", "No render pipeline");
+        throw std::runtime_error("createRenderPipeline() has to be called before recordDraw()!");
+    }
+
+    ParticleRenderConstants renderConstants{};
+    std::memcpy(renderConstants.viewProjection, viewProjection, sizeof(renderConstants.viewProjection));
+    renderConstants.list = current;
+    renderConstants.maxParticles = maxParticles;
+    renderConstants.size = size;
+
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, renderPipeline);
+    vk.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, renderPipelineLayout, 0, 1,
+                               &descriptorSet, 0, nullptr);
+    vk.vkCmdPushConstants(commandBuffer, renderPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0,
+                          sizeof(ParticleRenderConstants), &renderConstants);
+    //Instance count was written by the last simulation step
+    vk.vkCmdDrawIndirect(commandBuffer, counterBuffer, drawOffset, 1, sizeof(VkDrawIndirectCommand));
+}
+
+PPGL::ParticleSystem::~ParticleSystem() {
+    waitForSimulation();
+
+    if(queryPool != VK_NULL_HANDLE) {
+        vk.vkDestroyQueryPool(device, queryPool, vulkan.getAllocator());
+    }
+    vk.vkDestroyFence(device, fence, vulkan.getAllocator());
+    vk.vkDestroyCommandPool(device, commandPool, vulkan.getAllocator());
+
+    if(renderPipeline != VK_NULL_HANDLE) {
+        vk.vkDestroyPipeline(device, renderPipeline, vulkan.getAllocator());
+        vk.vkDestroyPipelineLayout(device, renderPipelineLayout, vulkan.getAllocator());
+    }
+    vk.vkDestroyPipeline(device, resetPipeline, vulkan.getAllocator());
+    vk.vkDestroyPipeline(device, emitPipeline, vulkan.getAllocator());
+    vk.vkDestroyPipeline(device, dispatchPipeline, vulkan.getAllocator());
+    vk.vkDestroyPipeline(device, simulatePipeline, vulkan.getAllocator());
+    vk.vkDestroyPipeline(device, finalizePipeline, vulkan.getAllocator());
+    vk.vkDestroyPipelineLayout(device, computePipelineLayout, vulkan.getAllocator());
+
+    vk.vkDestroyDescriptorPool(device, descriptorPool, vulkan.getAllocator());
+    vk.vkDestroyDescriptorSetLayout(device, descriptorSetLayout, vulkan.getAllocator());
+
+    vulkan.destroyBuffer(particleBuffer, particleMemory);
+    vulkan.destroyBuffer(deadListBuffer, deadListMemory);
+    vulkan.destroyBuffer(aliveListBuffer, aliveListMemory);
+    vulkan.destroyBuffer(counterBuffer, counterMemory);
+    vulkan.destroyBuffer(emitterBuffer, emitterMemory);
+    vulkan.destroyBuffer(readbackBuffer, readbackMemory);
+}
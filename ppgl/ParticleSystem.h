@@ -0,0 +1,304 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+#ifndef PPGL_PARTICLESYSTEM_H
+#define PPGL_PARTICLESYSTEM_H
+
+/*
+ * Headers
+ */
+#include <vector>
+
+#include "Vulkan.h"
+
+namespace PPGL {
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Stores the values of a particle emitter
+    /// \brief -
+    ///
+    /// \param position The position particles are emitted at.
+    /// \param velocity The base velocity of emitted particles.
+    /// \param spread The maximum random deviation added to the velocity on every axis.
+    /// \param color The initial color of emitted particles.
+    /// \param lifetime The lifetime of emitted particles in seconds.
+    /// \param rate The number of particles emitted per second.
+    ///
+    ////////////////////////////////////////////////////////////////
+    struct ParticleEmitter {
+        float position[3];
+        float velocity[3];
+        float spread;
+        float color[4];
+        float lifetime;
+        float rate;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Statistics of the last finished simulation step
+    /// \brief -
+    ///
+    /// \param aliveParticles The number of particles alive after the step.
+    /// \param emittedParticles The number of particles requested for emission.
+    /// \param simulationTime The GPU time of the step in milliseconds, 0 if timestamps are unsupported.
+    /// \param nanosecondsPerParticle The GPU time of the step per alive particle.
+    ///
+    ////////////////////////////////////////////////////////////////
+    struct ParticleStats {
+        uint32_t aliveParticles;
+        uint32_t emittedParticles;
+        double simulationTime;
+        double nanosecondsPerParticle;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Simulates particles with compute shaders on the compute queue
+    /// \brief and draws the survivors with one indirect draw.
+    /// \brief -
+    ///
+    ////////////////////////////////////////////////////////////////
+    class ParticleSystem {
+    public:
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Creates the particle buffers and compute pipelines.
+        /// \brief Vulkan::init has to be called before.
+        /// \brief -
+        ///
+        /// \param vulkan The initialized Vulkan instance.
+        /// \param maxParticles The maximum number of particles alive at once.
+        ///
+        ////////////////////////////////////////////////////////////////
+        ParticleSystem(const Vulkan &vulkan, uint32_t maxParticles = 1u << 20);
+        ~ParticleSystem();
+
+        ParticleSystem(const ParticleSystem &) = delete;
+        ParticleSystem &operator = (const ParticleSystem &) = delete;
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Adds an emitter.
+        /// \brief -
+        ///
+        /// \param emitter The values of the emitter.
+        ///
+        /// \return uint32_t
+        /// \return The id of the emitter
+        ///
+        ////////////////////////////////////////////////////////////////
+        uint32_t addEmitter(const ParticleEmitter &emitter);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Overwrites the values of an emitter.
+        /// \brief -
+        ///
+        /// \param id The id returned by addEmitter.
+        /// \param emitter The new values of the emitter.
+        ///
+        ////////////////////////////////////////////////////////////////
+        void setEmitter(uint32_t id, const ParticleEmitter &emitter);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Sets the gravity and linear drag applied to every particle.
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void setForces(float gravityX, float gravityY, float gravityZ, float drag);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Kills all particles and drops the fractional emissions carried over between steps.
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void reset();
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Emits and simulates one step on the compute queue.
+        /// \brief Waits for the previous step to finish on the CPU.
+        /// \brief -
+        ///
+        /// \param deltaTime The time step in seconds.
+        /// \param waitSemaphore Semaphore signaled when the last draw of the particles finished, or VK_NULL_HANDLE.
+        /// \param signalSemaphore Semaphore to signal when the step finished, or VK_NULL_HANDLE.
+        ///                        The graphics submission drawing the particles has to wait on it.
+        ///
+        ////////////////////////////////////////////////////////////////
+        void simulate(float deltaTime, VkSemaphore waitSemaphore = VK_NULL_HANDLE,
+                      VkSemaphore signalSemaphore = VK_NULL_HANDLE);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Creates the pipeline to draw the particles, needs to be called before recordDraw.
+        /// \brief Viewport and scissor are dynamic states.
+        /// \brief -
+        ///
+        /// \param renderPass The render pass the particles are drawn in.
+        /// \param subpass The subpass the particles are drawn in.
+        ///
+        ////////////////////////////////////////////////////////////////
+        void createRenderPipeline(VkRenderPass renderPass, uint32_t subpass = 0);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Records the indirect draw of all alive particles.
+        /// \brief -
+        ///
+        /// \param commandBuffer The command buffer, inside the render pass given to createRenderPipeline.
+        /// \param viewProjection The column major view projection matrix.
+        /// \param size The half size of a particle quad in clip space.
+        ///
+        ////////////////////////////////////////////////////////////////
+        void recordDraw(VkCommandBuffer commandBuffer, const float viewProjection[16], float size);
+
+        //Getters
+        uint32_t getMaxParticles() const { return maxParticles; }
+        const ParticleStats &getStats() const { return stats; }
+
+    private:
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Creates the descriptor set binding all particle buffers
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void createDescriptorSet();
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Creates a compute pipeline of the particle pipeline layout
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        VkPipeline createComputePipeline(const uint32_t *code, size_t size);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Waits for the last step and reads its statistics
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void waitForSimulation();
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Records a barrier between two compute passes
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void computeBarrier(VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+
+        //Mirrors the push constants of the particle compute shaders
+        struct ComputeConstants {
+            float gravityDrag[4];
+            float deltaTime;
+            uint32_t current;
+            uint32_t emitTotal;
+            uint32_t emitterCount;
+            uint32_t maxParticles;
+        };
+
+        //Mirrors the Emitter struct of the particle shaders
+        struct GpuEmitter {
+            float positionLifetime[4];
+            float velocitySpread[4];
+            float color[4];
+            uint32_t emit[4];
+        };
+
+        //Maximum number of emitters, limits the size of the emitter buffer
+        static constexpr uint32_t maxEmitters = 64;
+        //Byte offsets of the indirect commands in the counter buffer
+        static constexpr VkDeviceSize dispatchOffset = 16;
+        static constexpr VkDeviceSize drawOffset = 32;
+        static constexpr VkDeviceSize counterSize = 48;
+
+        const Vulkan &vulkan;
+        const VulkanDispatch &vk;
+        VkDevice device;
+        uint32_t maxParticles;
+
+        //Emitters and the fraction of a particle not emitted yet
+        std::vector<ParticleEmitter> emitters;
+        std::vector<float> emitterRemainders;
+        uint32_t seed = 0;
+
+        ComputeConstants constants{};
+        //Alive list that gets simulated next and drawn after the step
+        uint32_t current = 0;
+
+        //Buffers
+        VkBuffer particleBuffer, deadListBuffer, aliveListBuffer, counterBuffer, emitterBuffer, readbackBuffer;
+        VkDeviceMemory particleMemory, deadListMemory, aliveListMemory, counterMemory, emitterMemory, readbackMemory;
+        GpuEmitter *mappedEmitters;
+        uint32_t *mappedReadback;
+
+        //Descriptors
+        VkDescriptorSetLayout descriptorSetLayout;
+        VkDescriptorPool descriptorPool;
+        VkDescriptorSet descriptorSet;
+
+        //Pipelines
+        VkPipelineLayout computePipelineLayout;
+        VkPipeline resetPipeline, emitPipeline, dispatchPipeline, simulatePipeline, finalizePipeline;
+        VkPipelineLayout renderPipelineLayout = VK_NULL_HANDLE;
+        VkPipeline renderPipeline = VK_NULL_HANDLE;
+
+        //Compute submission
+        VkCommandPool commandPool;
+        VkCommandBuffer commandBuffer;
+        VkFence fence;
+        bool submitted = false;
+
+        //Timestamps, only used if the compute queue supports them
+        VkQueryPool queryPool = VK_NULL_HANDLE;
+
+        ParticleStats stats{};
+    };
+}
+
+#endif //PPGL_PARTICLESYSTEM_H
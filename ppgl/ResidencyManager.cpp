@@ -0,0 +1,213 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include "ResidencyManager.h"
+
+PPGL::ResidencyManager::ResidencyManager(const Vulkan &vulkan, uint32_t framesInFlight, float budgetFraction) :
+        ResidencyManager(vulkan.getMemoryProperties(),
+                         [&vulkan](VkDeviceSize *heapBudgets, VkDeviceSize *heapUsages) {
+                             return vulkan.getMemoryBudget(heapBudgets, heapUsages);
+                         }, framesInFlight, budgetFraction)
+{
+}
+
+PPGL::ResidencyManager::ResidencyManager(const VkPhysicalDeviceMemoryProperties &memoryProperties,
+                                         std::function<bool(VkDeviceSize *, VkDeviceSize *)> readBudget,
+                                         uint32_t framesInFlight, float budgetFraction) :
+        memoryProperties (memoryProperties), readBudget (std::move(readBudget)), framesInFlight (framesInFlight),
+        budgetFraction (budgetFraction), frame (0)
+{
+    stats.heapCount = memoryProperties.memoryHeapCount;
+    for (uint32_t i = 0; i < stats.heapCount; ++i) {
+        stats.heaps[i].size = memoryProperties.memoryHeaps[i].size;
+    }
+
+    update();
+}
+
+PPGL::ResidencyManager::Resource &PPGL::ResidencyManager::getResource(uint32_t id, const char *func) {
+    if(id >= resources.size() || !resources[id].active) {
+        std::cout << PPGL::Exception("ResidencyManager.cpp", __LINE__, func, "Invalid resource id");
+        throw std::runtime_error("Invalid residency resource id!");
+    }
+
+    return resources[id];
+}
+
+uint32_t PPGL::ResidencyManager::track(VkDeviceSize size, uint32_t memoryTypeIndex, uint32_t priority,
+                                       std::function<void()> evict, std::function<void()> restore) {
+    if(memoryTypeIndex >= memoryProperties.memoryTypeCount) {
+        std::cout << PPGL::Exception("ResidencyManager.cpp", __LINE__, "track()", "Invalid memory type");
+        throw std::runtime_error("Invalid memory type index!");
+    }
+
+    Resource resource = {
+            size,
+            memoryProperties.memoryTypes[memoryTypeIndex].heapIndex,
+            priority,
+            frame,
+            true,
+            true,
+            std::move(evict),
+            std::move(restore)
+    };
+
+    //Evict before the new allocation pushes the heap over budget, instead of at the next update
+    makeRoom(resource.heap, size);
+
+    //The allocation is not part of the usage read at the last update yet
+    ResidencyHeapStats &heap = stats.heaps[resource.heap];
+    heap.residentBytes += size;
+    heap.usage += size;
+    ++stats.residentResources;
+
+    //Reuse the id of an untracked resource
+    if(!freeResources.empty()) {
+        uint32_t id = freeResources.back();
+        freeResources.pop_back();
+        resources[id] = std::move(resource);
+        return id;
+    }
+
+    resources.push_back(std::move(resource));
+    return uint32_t(resources.size() - 1);
+}
+
+void PPGL::ResidencyManager::untrack(uint32_t id) {
+    Resource &resource = getResource(id, "untrack()");
+    ResidencyHeapStats &heap = stats.heaps[resource.heap];
+
+    if(resource.resident) {
+        heap.usage -= std::min(heap.usage, resource.size);
+        heap.residentBytes -= resource.size;
+        --stats.residentResources;
+    } else {
+        heap.evictedBytes -= resource.size;
+        --stats.evictedResources;
+    }
+
+    resource.active = false;
+    resource.evict = nullptr;
+    resource.restore = nullptr;
+    freeResources.push_back(id);
+}
+
+void PPGL::ResidencyManager::setPriority(uint32_t id, uint32_t priority) {
+    getResource(id, "setPriority()").priority = priority;
+}
+
+bool PPGL::ResidencyManager::use(uint32_t id) {
+    Resource &resource = getResource(id, "use()");
+    resource.lastUsed = frame;
+    if(resource.resident) {
+        return false;
+    }
+
+    uint32_t heapIndex = resource.heap;
+    VkDeviceSize size = resource.size;
+
+    //Restore on demand, after making room for it
+    makeRoom(heapIndex, size);
+    resources[id].restore();
+
+    //The callback may have tracked resources, which invalidates the reference
+    resources[id].resident = true;
+    ResidencyHeapStats &heap = stats.heaps[heapIndex];
+    heap.usage += size;
+    heap.residentBytes += size;
+    heap.evictedBytes -= size;
+    ++stats.residentResources;
+    --stats.evictedResources;
+    ++stats.restores;
+
+    return true;
+}
+
+void PPGL::ResidencyManager::update() {
+    ++frame;
+    stats.evictions = 0;
+    stats.restores = 0;
+
+    //Read budget and usage of the whole process, or fall back to the heap sizes and own bookkeeping
+    VkDeviceSize budgets[VK_MAX_MEMORY_HEAPS];
+    VkDeviceSize usages[VK_MAX_MEMORY_HEAPS];
+    stats.driverBudget = readBudget(budgets, usages);
+    for (uint32_t i = 0; i < stats.heapCount; ++i) {
+        ResidencyHeapStats &heap = stats.heaps[i];
+        heap.budget = stats.driverBudget ? budgets[i] : heap.size;
+        heap.usage = stats.driverBudget ? usages[i] : heap.residentBytes;
+    }
+
+    //Evict from heaps over budget
+    for (uint32_t i = 0; i < stats.heapCount; ++i) {
+        makeRoom(i, 0);
+    }
+}
+
+void PPGL::ResidencyManager::makeRoom(uint32_t heapIndex, VkDeviceSize bytes) {
+    ResidencyHeapStats &heap = stats.heaps[heapIndex];
+    const VkDeviceSize target = VkDeviceSize(double(heap.budget) * budgetFraction);
+    if(heap.usage + bytes <= target) {
+        return;
+    }
+
+    //Resident resources of the heap the GPU is done with
+    candidates.clear();
+    for (uint32_t i = 0; i < resources.size(); ++i) {
+        const Resource &resource = resources[i];
+        if(resource.active && resource.resident && resource.heap == heapIndex &&
+           frame - resource.lastUsed >= framesInFlight) {
+            candidates.push_back(i);
+        }
+    }
+
+    //Lowest priority first, least recently used first within a priority
+    std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) {
+        const Resource &resourceA = resources[a];
+        const Resource &resourceB = resources[b];
+        if(resourceA.priority != resourceB.priority) {
+            return resourceA.priority < resourceB.priority;
+        }
+        return resourceA.lastUsed < resourceB.lastUsed;
+    });
+
+    for (uint32_t id : candidates) {
+        if(heap.usage + bytes <= target) {
+            break;
+        }
+
+        resources[id].evict();
+
+        Resource &resource = resources[id];
+        resource.resident = false;
+        heap.usage -= std::min(heap.usage, resource.size);
+        heap.residentBytes -= resource.size;
+        heap.evictedBytes += resource.size;
+        ++stats.evictedResources;
+        --stats.residentResources;
+        ++stats.evictions;
+    }
+}
@@ -0,0 +1,239 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+#ifndef PPGL_RESIDENCYMANAGER_H
+#define PPGL_RESIDENCYMANAGER_H
+
+/*
+ * Headers
+ */
+#include <functional>
+#include <vector>
+
+#include "Vulkan.h"
+
+namespace PPGL {
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Memory of one heap as seen by the ResidencyManager
+    /// \brief -
+    ///
+    /// \param size The size of the heap.
+    /// \param budget The budget of the process, from VK_EXT_memory_budget or a fraction of the heap size.
+    /// \param usage The usage of the process, from VK_EXT_memory_budget or the resident tracked bytes.
+    /// \param residentBytes The bytes of tracked resources in memory.
+    /// \param evictedBytes The bytes of tracked resources evicted.
+    ///
+    ////////////////////////////////////////////////////////////////
+    struct ResidencyHeapStats {
+        VkDeviceSize size;
+        VkDeviceSize budget;
+        VkDeviceSize usage;
+        VkDeviceSize residentBytes;
+        VkDeviceSize evictedBytes;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Statistics of the ResidencyManager
+    /// \brief -
+    ///
+    /// \param driverBudget TRUE if budget and usage come from VK_EXT_memory_budget.
+    /// \param heapCount The number of valid entries in heaps.
+    /// \param residentResources The number of tracked resources in memory.
+    /// \param evictedResources The number of tracked resources evicted.
+    /// \param evictions The number of evictions since the last update.
+    /// \param restores The number of restores since the last update.
+    ///
+    ////////////////////////////////////////////////////////////////
+    struct ResidencyStats {
+        bool driverBudget;
+        uint32_t heapCount;
+        ResidencyHeapStats heaps[VK_MAX_MEMORY_HEAPS];
+        uint32_t residentResources;
+        uint32_t evictedResources;
+        uint32_t evictions;
+        uint32_t restores;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Keeps the memory usage of tracked resources within the budget of each heap.
+    /// \brief Least recently used resources with the lowest priority get evicted when a heap
+    /// \brief is over budget, and get restored when they are used again.
+    /// \brief -
+    ///
+    ////////////////////////////////////////////////////////////////
+    class ResidencyManager {
+    public:
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Creates the residency manager.
+        /// \brief Vulkan::init has to be called before.
+        /// \brief -
+        ///
+        /// \param vulkan The initialized Vulkan instance.
+        /// \param framesInFlight Resources used in this many of the last frames are never evicted,
+        ///                       as the GPU may still use them.
+        /// \param budgetFraction The fraction of the budget that may be used, leaves room for other allocations.
+        ///
+        ////////////////////////////////////////////////////////////////
+        ResidencyManager(const Vulkan &vulkan, uint32_t framesInFlight = 2, float budgetFraction = 0.9f);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Creates the residency manager for the given heaps, without a device.
+        /// \brief -
+        ///
+        /// \param memoryProperties The memory types and heaps resources are allocated from.
+        /// \param readBudget Reads the budget and usage of every heap, returns FALSE if they are unknown.
+        /// \param framesInFlight Resources used in this many of the last frames are never evicted.
+        /// \param budgetFraction The fraction of the budget that may be used.
+        ///
+        ////////////////////////////////////////////////////////////////
+        ResidencyManager(const VkPhysicalDeviceMemoryProperties &memoryProperties,
+                         std::function<bool(VkDeviceSize *, VkDeviceSize *)> readBudget,
+                         uint32_t framesInFlight = 2, float budgetFraction = 0.9f);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Tracks a resource, like a texture or a streaming buffer.
+        /// \brief Evicts other resources first if the heap would exceed its budget.
+        /// \brief -
+        ///
+        /// \param size The size of the memory of the resource.
+        /// \param memoryTypeIndex The memory type the resource is allocated from.
+        /// \param priority Resources with a higher priority get evicted later.
+        /// \param evict Frees the memory of the resource.
+        /// \param restore Allocates the memory of the resource again and restores its content.
+        ///
+        /// \return uint32_t
+        /// \return The id of the resource
+        ///
+        ////////////////////////////////////////////////////////////////
+        uint32_t track(VkDeviceSize size, uint32_t memoryTypeIndex, uint32_t priority,
+                       std::function<void()> evict, std::function<void()> restore);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Stops tracking a resource, its id may be reused by track.
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void untrack(uint32_t id);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Changes the priority of a resource.
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void setPriority(uint32_t id, uint32_t priority);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Marks a resource as used in this frame, restores it if it got evicted.
+        /// \brief Has to be called before the resource is recorded into a command buffer.
+        /// \brief -
+        ///
+        /// \return bool
+        /// \return TRUE if the resource got restored
+        ///
+        ////////////////////////////////////////////////////////////////
+        bool use(uint32_t id);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Starts a new frame, reads the budget and evicts resources of heaps over budget.
+        /// \brief Has to be called once per frame.
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void update();
+
+        //Setters
+        void setBudgetFraction(float fraction) { budgetFraction = fraction; }
+
+        //Getters
+        bool isResident(uint32_t id) const { return resources.at(id).resident; }
+        const ResidencyStats &getStats() const { return stats; }
+
+    private:
+        struct Resource {
+            VkDeviceSize size;
+            uint32_t heap;
+            uint32_t priority;
+            uint64_t lastUsed;
+            bool resident;
+            bool active;
+            std::function<void()> evict;
+            std::function<void()> restore;
+        };
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Evicts resources of a heap until bytes more fit into its budget
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void makeRoom(uint32_t heap, VkDeviceSize bytes);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Gets a tracked resource, throws if the id is invalid
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        Resource &getResource(uint32_t id, const char *func);
+
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        std::function<bool(VkDeviceSize *, VkDeviceSize *)> readBudget;
+        uint32_t framesInFlight;
+        float budgetFraction;
+        uint64_t frame;
+
+        std::vector<Resource> resources;
+        std::vector<uint32_t> freeResources;
+        //Reused eviction candidates
+        std::vector<uint32_t> candidates;
+
+        ResidencyStats stats{};
+    };
+}
+
+#endif //PPGL_RESIDENCYMANAGER_H
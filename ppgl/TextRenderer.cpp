@@ -0,0 +1,564 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include "TextRenderer.h"
+
+/*
+ * SPIR-V of the text shaders, generated at build time from shaders/
+ */
+static const uint32_t textVertexCode[] =
+#include "shaders/text.vert.inc"
+;
+static const uint32_t textFragmentCode[] =
+#include "shaders/text.frag.inc"
+;
+
+//Format of the atlas pages, one coverage or distance byte per pixel
+static const VkFormat pageFormat = VK_FORMAT_R8_UNORM;
+
+//Records a layout transition of a whole page
+static void pageBarrier(const PPGL::VulkanDispatch &vk, VkCommandBuffer commandBuffer, VkImage image,
+                        VkImageLayout oldLayout, VkImageLayout newLayout,
+                        VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                        VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+    VkImageMemoryBarrier imageMemoryBarrier = {
+            VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            nullptr,
+            srcAccess,
+            dstAccess,
+            oldLayout,
+            newLayout,
+            VK_QUEUE_FAMILY_IGNORED,
+            VK_QUEUE_FAMILY_IGNORED,
+            image,
+            {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1}
+    };
+    vk.vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+}
+
+PPGL::TextRenderer::TextRenderer(const Vulkan &vulkan, uint32_t maxGlyphs, uint32_t framesInFlight,
+                                 uint32_t maxPages, uint32_t uploadSize) :
+        vulkan (vulkan), vk (vulkan.getDispatch()), device (vulkan.getDevice()), maxGlyphs (maxGlyphs),
+        framesInFlight (framesInFlight), maxPages (maxPages), uploadSize (uploadSize)
+{
+    VkResult errorDescription;
+
+    /*
+     * Create buffers
+     */
+    vulkan.createBuffer(sizeof(GlyphInstance) * maxGlyphs * framesInFlight, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                        instanceBuffer, instanceMemory);
+    //New glyphs are written here and copied to the pages during recordUpload
+    vulkan.createBuffer(VkDeviceSize(uploadSize) * framesInFlight, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                        stagingBuffer, stagingMemory);
+    errorDescription = vk.vkMapMemory(device, instanceMemory, 0, VK_WHOLE_SIZE, 0,
+                                      reinterpret_cast<void **>(&mappedInstances));
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("TextRenderer.cpp", __LINE__, "vkMapMemory()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to map text instance memory!");
+    }
+    errorDescription = vk.vkMapMemory(device, stagingMemory, 0, VK_WHOLE_SIZE, 0,
+                                      reinterpret_cast<void **>(&mappedStaging));
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("TextRenderer.cpp", __LINE__, "vkMapMemory()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to map text staging memory!");
+    }
+
+    createDescriptorPool();
+}
+
+void PPGL::TextRenderer::createDescriptorPool() {
+    VkResult errorDescription;
+
+    //Bitmap fonts keep their pixels sharp, distance fields are interpolated
+    VkSamplerCreateInfo samplerCreateInfo = {
+            VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+            nullptr,
+            0,
+            VK_FILTER_NEAREST,
+            VK_FILTER_NEAREST,
+            VK_SAMPLER_MIPMAP_MODE_NEAREST,
+            VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+            VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+            VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+            0.0f,
+            VK_FALSE,
+            1.0f,
+            VK_FALSE,
+            VK_COMPARE_OP_ALWAYS,
+            0.0f,
+            0.0f,
+            VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK,
+            VK_FALSE
+    };
+    errorDescription = vk.vkCreateSampler(device, &samplerCreateInfo, vulkan.getAllocator(), &nearestSampler);
+    if(errorDescription == VK_SUCCESS) {
+        samplerCreateInfo.magFilter = VK_FILTER_LINEAR;
+        samplerCreateInfo.minFilter = VK_FILTER_LINEAR;
+        errorDescription = vk.vkCreateSampler(device, &samplerCreateInfo, vulkan.getAllocator(), &linearSampler);
+    }
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("TextRenderer.cpp", __LINE__, "vkCreateSampler()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create text sampler!");
+    }
+
+    VkDescriptorSetLayoutBinding binding = {
+            0,
+            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            1,
+            VK_SHADER_STAGE_FRAGMENT_BIT,
+            nullptr
+    };
+    VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = {
+            VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            nullptr,
+            0,
+            1,
+            &binding
+    };
+    errorDescription = vk.vkCreateDescriptorSetLayout(device, &descriptorSetLayoutCreateInfo, vulkan.getAllocator(),
+                                                      &descriptorSetLayout);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("TextRenderer.cpp", __LINE__, "vkCreateDescriptorSetLayout()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create text descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize = {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, maxPages};
+    VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {
+            VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            nullptr,
+            0,
+            maxPages,
+            1,
+            &poolSize
+    };
+    errorDescription = vk.vkCreateDescriptorPool(device, &descriptorPoolCreateInfo, vulkan.getAllocator(),
+                                                 &descriptorPool);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("TextRenderer.cpp", __LINE__, "vkCreateDescriptorPool()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create text descriptor pool!");
+    }
+}
+
+PPGL::TextRenderer::FontAtlas &PPGL::TextRenderer::getAtlas(Font &font) {
+    if(lastAtlas < atlases.size() && atlases[lastAtlas].font == &font) {
+        return atlases[lastAtlas];
+    }
+
+    for (size_t i = 0; i < atlases.size(); ++i) {
+        if(atlases[i].font == &font) {
+            lastAtlas = i;
+            return atlases[i];
+        }
+    }
+
+    //A row of a page has to fit into the staging region
+    if(font.getPageSize() > uploadSize) {
+        std::cout << PPGL::Exception("TextRenderer.cpp", __LINE__, "getAtlas()", "Page size exceeds upload size");
+        throw std::runtime_error("Font page size is too large for the text renderer!");
+    }
+
+    atlases.push_back({&font, {}, {}});
+    lastAtlas = atlases.size() - 1;
+    return atlases.back();
+}
+
+void PPGL::TextRenderer::drawText(Font &font, const std::string &text, float x, float y, float scale,
+                                  const float color[4]) {
+    auto start = std::chrono::steady_clock::now();
+
+    FontAtlas &atlas = getAtlas(font);
+    const TextLayout &layout = font.layout(text);
+    if(queuedGlyphs + layout.glyphs.size() > maxGlyphs) {
+        std::cout << PPGL::Exception("TextRenderer.cpp", __LINE__, "drawText()", "Too many glyphs");
+        throw std::runtime_error("Maximum number of glyphs per frame reached!");
+    }
+
+    //New glyphs may have opened new pages
+    if(atlas.instances.size() < font.getPageCount()) {
+        atlas.instances.resize(font.getPageCount());
+    }
+
+    const float white[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    if(color == nullptr) {
+        color = white;
+    }
+
+    for (const TextLayoutGlyph &glyph : layout.glyphs) {
+        atlas.instances[glyph.page].push_back({
+                {x + glyph.x * scale, y + glyph.y * scale, glyph.width * scale, glyph.height * scale},
+                {glyph.u0, glyph.v0, glyph.u1, glyph.v1},
+                {color[0], color[1], color[2], color[3]}
+        });
+    }
+    queuedGlyphs += uint32_t(layout.glyphs.size());
+
+    cpuTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void PPGL::TextRenderer::createPage(VkCommandBuffer commandBuffer, FontAtlas &atlas) {
+    VkResult errorDescription;
+
+    if(pageCount >= maxPages) {
+        std::cout << PPGL::Exception("TextRenderer.cpp", __LINE__, "createPage()", "Too many pages");
+        throw std::runtime_error("Maximum number of font pages reached!");
+    }
+
+    AtlasPage page{};
+    uint32_t pageSize = atlas.font->getPageSize();
+    vulkan.createImage(pageSize, pageSize, pageFormat, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                       page.image, page.memory);
+
+    VkImageViewCreateInfo imageViewCreateInfo = {
+            VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            nullptr,
+            0,
+            page.image,
+            VK_IMAGE_VIEW_TYPE_2D,
+            pageFormat,
+            {},
+            {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1}
+    };
+    errorDescription = vk.vkCreateImageView(device, &imageViewCreateInfo, vulkan.getAllocator(), &page.view);
+    if(errorDescription != VK_SUCCESS) {
+        vulkan.destroyImage(page.image, page.memory);
+        std::cout << PPGL::Exception("TextRenderer.cpp", __LINE__, "vkCreateImageView()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create font page view!");
+    }
+
+    VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {
+            VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            nullptr,
+            descriptorPool,
+            1,
+            &descriptorSetLayout
+    };
+    errorDescription = vk.vkAllocateDescriptorSets(device, &descriptorSetAllocateInfo, &page.descriptorSet);
+    if(errorDescription != VK_SUCCESS) {
+        vk.vkDestroyImageView(device, page.view, vulkan.getAllocator());
+        vulkan.destroyImage(page.image, page.memory);
+        std::cout << PPGL::Exception("TextRenderer.cpp", __LINE__, "vkAllocateDescriptorSets()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to allocate font page descriptor set!");
+    }
+
+    VkDescriptorImageInfo imageInfo = {
+            atlas.font->getType() == FontType::SDF ? linearSampler : nearestSampler,
+            page.view,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+    };
+    VkWriteDescriptorSet write = {
+            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            nullptr,
+            page.descriptorSet,
+            0,
+            0,
+            1,
+            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            &imageInfo,
+            nullptr,
+            nullptr
+    };
+    vk.vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+
+    //Clear the page, so filtering at glyph borders only reads empty pixels
+    VkClearColorValue clearColor{};
+    VkImageSubresourceRange range = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    pageBarrier(vk, commandBuffer, page.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+    vk.vkCmdClearColorImage(commandBuffer, page.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clearColor, 1, &range);
+    pageBarrier(vk, commandBuffer, page.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT);
+
+    atlas.pages.push_back(page);
+    ++pageCount;
+}
+
+void PPGL::TextRenderer::recordUpload(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+    if(frameIndex >= framesInFlight) {
+        std::cout << PPGL::Exception("TextRenderer.cpp", __LINE__, "recordUpload()", "Invalid frame index");
+        throw std::runtime_error("Invalid frame index!");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    uint8_t *staging = mappedStaging + size_t(frameIndex) * uploadSize;
+    VkDeviceSize stagingBase = VkDeviceSize(frameIndex) * uploadSize;
+    uint32_t stagingOffset = 0;
+    uint32_t firstInstance = frameIndex * maxGlyphs;
+    pageDraws.clear();
+    stats.uploadedBytes = 0;
+
+    for (FontAtlas &atlas : atlases) {
+        Font &font = *atlas.font;
+        while (atlas.pages.size() < font.getPageCount()) {
+            createPage(commandBuffer, atlas);
+        }
+
+        //Copy the glyphs added since the last upload, as many rows as fit into this frame's staging region
+        for (uint32_t i = 0; i < font.getPageCount(); ++i) {
+            uint32_t x, y, width, height;
+            if(stagingOffset >= uploadSize || !font.getDirtyRect(i, x, y, width, height)) {
+                continue;
+            }
+
+            uint32_t rows = std::min(height, (uploadSize - stagingOffset) / width);
+            if(rows == 0) {
+                continue;
+            }
+
+            const uint8_t *pixels = font.getPagePixels(i);
+            for (uint32_t row = 0; row < rows; ++row) {
+                std::memcpy(staging + stagingOffset + size_t(row) * width,
+                            pixels + size_t(y + row) * font.getPageSize() + x, width);
+            }
+
+            VkBufferImageCopy bufferImageCopy = {
+                    stagingBase + stagingOffset,
+                    width,
+                    rows,
+                    {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+                    {int32_t(x), int32_t(y), 0},
+                    {width, rows, 1}
+            };
+            VkImage image = atlas.pages[i].image;
+            pageBarrier(vk, commandBuffer, image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+            vk.vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
+                                      &bufferImageCopy);
+            pageBarrier(vk, commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                        VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+
+            font.clearDirtyRect(i, rows);
+            stats.uploadedBytes += width * rows;
+            //Buffer offsets of copies to images have to be a multiple of 4
+            stagingOffset += (width * rows + 3) & ~3u;
+        }
+
+        //Write the queued glyphs of every page behind each other, one draw per page
+        for (uint32_t i = 0; i < atlas.instances.size(); ++i) {
+            std::vector<GlyphInstance> &instances = atlas.instances[i];
+            if(instances.empty()) {
+                continue;
+            }
+
+            std::memcpy(mappedInstances + firstInstance, instances.data(), instances.size() * sizeof(GlyphInstance));
+            pageDraws.push_back({atlas.pages[i].descriptorSet, firstInstance, uint32_t(instances.size()),
+                                 font.getType() == FontType::SDF ? 1u : 0u});
+            firstInstance += uint32_t(instances.size());
+            instances.clear();
+        }
+
+        font.collectLayouts(layoutLifetime);
+    }
+
+    cpuTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    //Finish the frame
+    stats.glyphs = queuedGlyphs;
+    stats.draws = uint32_t(pageDraws.size());
+    stats.cpuTime = cpuTime;
+    stats.glyphsPerMillisecond = cpuTime > 0.0 ? queuedGlyphs / cpuTime : 0.0;
+    queuedGlyphs = 0;
+    cpuTime = 0.0;
+}
+
+void PPGL::TextRenderer::createRenderPipeline(VkRenderPass renderPass, uint32_t subpass) {
+    VkResult errorDescription;
+
+    VkPushConstantRange pushConstantRange = {
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+            0,
+            sizeof(TextConstants)
+    };
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {
+            VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            nullptr,
+            0,
+            1,
+            &descriptorSetLayout,
+            1,
+            &pushConstantRange
+    };
+    errorDescription = vk.vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, vulkan.getAllocator(),
+                                                 &renderPipelineLayout);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("TextRenderer.cpp", __LINE__, "vkCreatePipelineLayout()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create text render pipeline layout!");
+    }
+
+    VkShaderModule vertexModule = vulkan.createShaderModule(textVertexCode, sizeof(textVertexCode));
+    VkShaderModule fragmentModule = vulkan.createShaderModule(textFragmentCode, sizeof(textFragmentCode));
+    VkPipelineShaderStageCreateInfo stages[2] = {
+            {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, nullptr, 0, VK_SHADER_STAGE_VERTEX_BIT,
+             vertexModule, "main", nullptr},
+            {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, nullptr, 0, VK_SHADER_STAGE_FRAGMENT_BIT,
+             fragmentModule, "main", nullptr}
+    };
+
+    //One glyph instance per quad, the corners are generated from the vertex index
+    VkVertexInputBindingDescription bindingDescription = {
+            0, sizeof(GlyphInstance), VK_VERTEX_INPUT_RATE_INSTANCE
+    };
+    VkVertexInputAttributeDescription attributeDescriptions[3] = {
+            {0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(GlyphInstance, rect)},
+            {1, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(GlyphInstance, uv)},
+            {2, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(GlyphInstance, color)}
+    };
+    VkPipelineVertexInputStateCreateInfo vertexInputState = {
+            VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO, nullptr, 0, 1, &bindingDescription,
+            3, attributeDescriptions
+    };
+    VkPipelineInputAssemblyStateCreateInfo inputAssemblyState = {
+            VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO, nullptr, 0,
+            VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE
+    };
+    VkPipelineViewportStateCreateInfo viewportState = {
+            VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO, nullptr, 0, 1, nullptr, 1, nullptr
+    };
+    VkPipelineRasterizationStateCreateInfo rasterizationState = {
+            VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO, nullptr, 0, VK_FALSE, VK_FALSE,
+            VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE, VK_FALSE, 0.0f, 0.0f, 0.0f, 1.0f
+    };
+    VkPipelineMultisampleStateCreateInfo multisampleState = {
+            VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO, nullptr, 0, VK_SAMPLE_COUNT_1_BIT, VK_FALSE,
+            0.0f, nullptr, VK_FALSE, VK_FALSE
+    };
+    //Text is an overlay, drawn on top without depth
+    VkPipelineDepthStencilStateCreateInfo depthStencilState = {
+            VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO, nullptr, 0, VK_FALSE, VK_FALSE,
+            VK_COMPARE_OP_ALWAYS, VK_FALSE, VK_FALSE, {}, {}, 0.0f, 1.0f
+    };
+    VkPipelineColorBlendAttachmentState colorBlendAttachment = {
+            VK_TRUE,
+            VK_BLEND_FACTOR_SRC_ALPHA, VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA, VK_BLEND_OP_ADD,
+            VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA, VK_BLEND_OP_ADD,
+            VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+    };
+    VkPipelineColorBlendStateCreateInfo colorBlendState = {
+            VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO, nullptr, 0, VK_FALSE, VK_LOGIC_OP_COPY,
+            1, &colorBlendAttachment, {0.0f, 0.0f, 0.0f, 0.0f}
+    };
+    VkDynamicState dynamicStates[2] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState = {
+            VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO, nullptr, 0, 2, dynamicStates
+    };
+
+    VkGraphicsPipelineCreateInfo graphicsPipelineCreateInfo = {
+            VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+            nullptr,
+            0,
+            2,
+            stages,
+            &vertexInputState,
+            &inputAssemblyState,
+            nullptr,
+            &viewportState,
+            &rasterizationState,
+            &multisampleState,
+            &depthStencilState,
+            &colorBlendState,
+            &dynamicState,
+            renderPipelineLayout,
+            renderPass,
+            subpass,
+            VK_NULL_HANDLE,
+            -1
+    };
+    errorDescription = vk.vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &graphicsPipelineCreateInfo,
+                                                    vulkan.getAllocator(), &renderPipeline);
+    vk.vkDestroyShaderModule(device, vertexModule, vulkan.getAllocator());
+    vk.vkDestroyShaderModule(device, fragmentModule, vulkan.getAllocator());
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("TextRenderer.cpp", __LINE__, "vkCreateGraphicsPipelines()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create text render pipeline!");
+    }
+}
+
+void PPGL::TextRenderer::recordDraw(VkCommandBuffer commandBuffer, float viewportWidth, float viewportHeight) {
+    if(renderPipeline == VK_NULL_HANDLE) {
+        std::cout << PPGL::Exception("TextRenderer.cpp", __LINE__, "recordDraw()", "No render pipeline");
+        throw std::runtime_error("createRenderPipeline() has to be called before recordDraw()!");
+    }
+
+    if(pageDraws.empty()) {
+        return;
+    }
+
+    TextConstants textConstants = {{1.0f / viewportWidth, 1.0f / viewportHeight}, 0};
+    VkDeviceSize offset = 0;
+
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, renderPipeline);
+    vk.vkCmdBindVertexBuffers(commandBuffer, 0, 1, &instanceBuffer, &offset);
+    for (const PageDraw &pageDraw : pageDraws) {
+        textConstants.sdf = pageDraw.sdf;
+        vk.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, renderPipelineLayout, 0, 1,
+                                   &pageDraw.descriptorSet, 0, nullptr);
+        vk.vkCmdPushConstants(commandBuffer, renderPipelineLayout,
+                              VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(TextConstants),
+                              &textConstants);
+        vk.vkCmdDraw(commandBuffer, 6, pageDraw.instanceCount, 0, pageDraw.firstInstance);
+    }
+}
+
+PPGL::TextRenderer::~TextRenderer() {
+    if(renderPipeline != VK_NULL_HANDLE) {
+        vk.vkDestroyPipeline(device, renderPipeline, vulkan.getAllocator());
+        vk.vkDestroyPipelineLayout(device, renderPipelineLayout, vulkan.getAllocator());
+    }
+
+    for (FontAtlas &atlas : atlases) {
+        for (AtlasPage &page : atlas.pages) {
+            vk.vkDestroyImageView(device, page.view, vulkan.getAllocator());
+            vulkan.destroyImage(page.image, page.memory);
+        }
+    }
+
+    vk.vkDestroyDescriptorPool(device, descriptorPool, vulkan.getAllocator());
+    vk.vkDestroyDescriptorSetLayout(device, descriptorSetLayout, vulkan.getAllocator());
+    vk.vkDestroySampler(device, nearestSampler, vulkan.getAllocator());
+    vk.vkDestroySampler(device, linearSampler, vulkan.getAllocator());
+
+    vulkan.destroyBuffer(instanceBuffer, instanceMemory);
+    vulkan.destroyBuffer(stagingBuffer, stagingMemory);
+}
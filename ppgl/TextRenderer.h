@@ -0,0 +1,256 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+#ifndef PPGL_TEXTRENDERER_H
+#define PPGL_TEXTRENDERER_H
+
+/*
+ * Headers
+ */
+#include <string>
+#include <vector>
+
+#include "Font.h"
+#include "Vulkan.h"
+
+namespace PPGL {
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Statistics of the last frame of a TextRenderer
+    /// \brief -
+    ///
+    /// \param glyphs The number of glyphs drawn.
+    /// \param draws The number of draw calls, one per used font page.
+    /// \param uploadedBytes The number of atlas bytes copied to the pages.
+    /// \param cpuTime The CPU time of drawText and recordUpload in milliseconds.
+    /// \param glyphsPerMillisecond The glyphs prepared per millisecond of CPU time.
+    ///
+    ////////////////////////////////////////////////////////////////
+    struct TextStats {
+        uint32_t glyphs;
+        uint32_t draws;
+        uint32_t uploadedBytes;
+        double cpuTime;
+        double glyphsPerMillisecond;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Draws text of bitmap and SDF fonts. Glyphs are cached in atlas pages on first use,
+    /// \brief layouts of unchanged strings are reused and all glyphs of a page are drawn
+    /// \brief with one instanced draw.
+    /// \brief -
+    ///
+    ////////////////////////////////////////////////////////////////
+    class TextRenderer {
+    public:
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Creates the instance and staging buffers.
+        /// \brief Vulkan::init has to be called before.
+        /// \brief -
+        ///
+        /// \param vulkan The initialized Vulkan instance.
+        /// \param maxGlyphs The maximum number of glyphs drawn per frame.
+        /// \param framesInFlight The number of frames recorded before the first one finished.
+        /// \param maxPages The maximum number of atlas pages of all fonts.
+        /// \param uploadSize The maximum number of atlas bytes uploaded per frame.
+        ///
+        ////////////////////////////////////////////////////////////////
+        TextRenderer(const Vulkan &vulkan, uint32_t maxGlyphs = 1u << 16, uint32_t framesInFlight = 2,
+                     uint32_t maxPages = 64, uint32_t uploadSize = 1u << 22);
+        ~TextRenderer();
+
+        TextRenderer(const TextRenderer &) = delete;
+        TextRenderer &operator = (const TextRenderer &) = delete;
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Queues a text for the current frame. The font has to outlive the renderer.
+        /// \brief -
+        ///
+        /// \param font The font of the text.
+        /// \param text The UTF-8 text, lines are separated by '\n'.
+        /// \param x The left edge of the text in pixels.
+        /// \param y The top edge of the text in pixels.
+        /// \param scale The size of a font pixel in pixels.
+        /// \param color The RGBA color of the text, white if nullptr.
+        ///
+        ////////////////////////////////////////////////////////////////
+        void drawText(Font &font, const std::string &text, float x, float y, float scale = 1.0f,
+                      const float color[4] = nullptr);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Uploads new glyphs and the queued glyph instances of the frame.
+        /// \brief Has to be recorded outside of a render pass, before recordDraw.
+        /// \brief Glyphs exceeding the upload size stay empty until a later frame.
+        /// \brief -
+        ///
+        /// \param commandBuffer The command buffer of the graphics queue.
+        /// \param frameIndex The index of the frame in flight, 0 to framesInFlight - 1.
+        ///
+        ////////////////////////////////////////////////////////////////
+        void recordUpload(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Creates the pipeline to draw text, needs to be called before recordDraw.
+        /// \brief Viewport and scissor are dynamic states.
+        /// \brief -
+        ///
+        /// \param renderPass The render pass text is drawn in.
+        /// \param subpass The subpass text is drawn in.
+        ///
+        ////////////////////////////////////////////////////////////////
+        void createRenderPipeline(VkRenderPass renderPass, uint32_t subpass = 0);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Records one instanced draw per used font page for the glyphs of the last recordUpload.
+        /// \brief -
+        ///
+        /// \param commandBuffer The command buffer, inside the render pass given to createRenderPipeline.
+        /// \param viewportWidth The width of the viewport in pixels.
+        /// \param viewportHeight The height of the viewport in pixels.
+        ///
+        ////////////////////////////////////////////////////////////////
+        void recordDraw(VkCommandBuffer commandBuffer, float viewportWidth, float viewportHeight);
+
+        //Getters
+        uint32_t getMaxGlyphs() const { return maxGlyphs; }
+        const TextStats &getStats() const { return stats; }
+
+    private:
+        //Mirrors the instance input of the text vertex shader
+        struct GlyphInstance {
+            float rect[4];
+            float uv[4];
+            float color[4];
+        };
+
+        //Mirrors the push constants of the text shaders
+        struct TextConstants {
+            float inverseViewportSize[2];
+            uint32_t sdf;
+        };
+
+        //Device copy of a font page
+        struct AtlasPage {
+            VkImage image;
+            VkDeviceMemory memory;
+            VkImageView view;
+            VkDescriptorSet descriptorSet;
+        };
+
+        //Device pages and queued glyphs of a font
+        struct FontAtlas {
+            Font *font;
+            std::vector<AtlasPage> pages;
+            std::vector<std::vector<GlyphInstance>> instances;
+        };
+
+        //Instanced draw of one page
+        struct PageDraw {
+            VkDescriptorSet descriptorSet;
+            uint32_t firstInstance;
+            uint32_t instanceCount;
+            uint32_t sdf;
+        };
+
+        //Frames a layout is kept without being drawn
+        static constexpr uint32_t layoutLifetime = 60;
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Creates the samplers and the descriptor pool of the pages
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void createDescriptorPool();
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Creates the device image of a new font page and clears it
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void createPage(VkCommandBuffer commandBuffer, FontAtlas &atlas);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Gets the atlas of a font, creates it on first use
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        FontAtlas &getAtlas(Font &font);
+
+        const Vulkan &vulkan;
+        const VulkanDispatch &vk;
+        VkDevice device;
+        uint32_t maxGlyphs;
+        uint32_t framesInFlight;
+        uint32_t maxPages;
+        uint32_t uploadSize;
+
+        std::vector<FontAtlas> atlases;
+        //Atlas of the last drawText, most text is drawn with few fonts
+        size_t lastAtlas = 0;
+        uint32_t queuedGlyphs = 0;
+        std::vector<PageDraw> pageDraws;
+
+        //Per frame regions of the instances and the staged glyphs
+        VkBuffer instanceBuffer, stagingBuffer;
+        VkDeviceMemory instanceMemory, stagingMemory;
+        GlyphInstance *mappedInstances;
+        uint8_t *mappedStaging;
+
+        //Descriptors, one set per page
+        VkSampler nearestSampler, linearSampler;
+        VkDescriptorSetLayout descriptorSetLayout;
+        VkDescriptorPool descriptorPool;
+        uint32_t pageCount = 0;
+
+        VkPipelineLayout renderPipelineLayout = VK_NULL_HANDLE;
+        VkPipeline renderPipeline = VK_NULL_HANDLE;
+
+        //CPU time of the frame so far
+        double cpuTime = 0.0;
+        TextStats stats{};
+    };
+}
+
+#endif //PPGL_TEXTRENDERER_H
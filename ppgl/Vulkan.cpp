@@ -24,8 +24,29 @@
  */
 
 #include <vulkan/vulkan.h>
+#include <cstring>
 #include "ppgl.h"
 
+//Checks if an extension is in a list of extension properties
+static bool containsExtension(const std::vector<VkExtensionProperties> &extensions, const char *name) {
+    for (const VkExtensionProperties &extension : extensions) {
+        if(std::strcmp(extension.extensionName, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//Checks if an extension is in a list of extension names
+static bool containsExtension(const char *const *extensions, uint32_t count, const char *name) {
+    for (uint32_t i = 0; i < count; ++i) {
+        if(std::strcmp(extensions[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 PPGL::Vulkan::Vulkan() {
     //Check for vulkan support, if not supported exception
     if(!glfwVulkanSupported()) {
@@ -35,6 +56,9 @@ PPGL::Vulkan::Vulkan() {
                                      (description == nullptr) ? "No vulkan support" : description);
         throw std::runtime_error("No Vulkan support!");
     }
+
+    //Load the functions needed to create an instance
+    vk.loadGlobalFunctions();
 }
 
 void PPGL::Vulkan::init() {
@@ -58,6 +82,18 @@ void PPGL::Vulkan::createInstanceOfAppInfo() {
                 VK_API_VERSION_1_0
         };
 
+        //Extensions needed by glfw
+        instanceExtensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+
+        //Needed to query the memory budget, enabled if available
+        uint32_t availableExtensionCount = 0;
+        vk.vkEnumerateInstanceExtensionProperties(nullptr, &availableExtensionCount, nullptr);
+        std::vector<VkExtensionProperties> availableExtensions(availableExtensionCount);
+        vk.vkEnumerateInstanceExtensionProperties(nullptr, &availableExtensionCount, availableExtensions.data());
+        if(containsExtension(availableExtensions, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME)) {
+            instanceExtensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+        }
+
         //Structure to specify parameters of a newly created instance
         //specify's parameters for the instance for appInfo
         instanceCreateInfo = {
@@ -67,30 +103,39 @@ void PPGL::Vulkan::createInstanceOfAppInfo() {
                 &appInfo,
                 0,
                 nullptr,
-                glfwExtensionCount,
-                glfwExtensions
+                uint32_t(instanceExtensions.size()),
+                instanceExtensions.data()
         };
     }
 
     VkResult errorDescription;
 
     //Create instance of appInfo and check if creation went well
-    errorDescription = vkCreateInstance(&instanceCreateInfo, nullptr, &instance);
+    errorDescription = vk.vkCreateInstance(&instanceCreateInfo, nullptr, &instance);
     if(errorDescription != VK_SUCCESS) {
         std::cout << PPGL::Exception("Vulkan.cpp", 74, "vkCreateInstance()",
                                      ("VkResult: " + std::to_string(int(errorDescription))).c_str());
         throw std::runtime_error("Failed to create Instance for appInfo!");
     }
+
+    //Load the functions of the instance
+    vk.loadInstanceFunctions(instance);
+
+    //Check which of the optional extensions got enabled
+    physicalDeviceProperties2Enabled = vk.vkGetPhysicalDeviceMemoryProperties2KHR != nullptr &&
+                                       containsExtension(instanceCreateInfo.ppEnabledExtensionNames,
+                                                         instanceCreateInfo.enabledExtensionCount,
+                                                         VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
 }
 
 void PPGL::Vulkan::createPhysicalDevice() {
     VkResult errorDescription;
 
     //Get physical device count and resize physicalDevices to count
-    vkEnumeratePhysicalDevices(instance, &physicalDeviceCount, nullptr);
+    vk.vkEnumeratePhysicalDevices(instance, &physicalDeviceCount, nullptr);
     physicalDevices = new VkPhysicalDevice[physicalDeviceCount];
     //Create instance of Devices
-    errorDescription = vkEnumeratePhysicalDevices(instance, &physicalDeviceCount, physicalDevices);
+    errorDescription = vk.vkEnumeratePhysicalDevices(instance, &physicalDeviceCount, physicalDevices);
     //Error checking
     switch (errorDescription) {
         case VK_SUCCESS:
@@ -109,7 +154,7 @@ void PPGL::Vulkan::createPhysicalDevice() {
     physicalDeviceProperties = new VkPhysicalDeviceProperties[physicalDeviceCount];
     // create physical device properties for every physical device
     for (int i = 0; i < physicalDeviceCount; ++i) {
-        vkGetPhysicalDeviceProperties(physicalDevices[i], &physicalDeviceProperties[i]);
+        vk.vkGetPhysicalDeviceProperties(physicalDevices[i], &physicalDeviceProperties[i]);
     }
 
     //TODO: choose best physical device
@@ -121,75 +166,403 @@ void PPGL::Vulkan::getPhysicalDeviceQueueCreateInfo() {
      * Get physical device queue family properties
      */
     //Get count
-    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevices[usedPhysicalDevice], &pQueueFamilyPropertyCount, nullptr);
+    vk.vkGetPhysicalDeviceQueueFamilyProperties(physicalDevices[usedPhysicalDevice], &pQueueFamilyPropertyCount, nullptr);
     //Set array size
     pQueueFamilyProperties = new VkQueueFamilyProperties[pQueueFamilyPropertyCount];
     //Get physical device queue family properties
-    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevices[usedPhysicalDevice], &pQueueFamilyPropertyCount, pQueueFamilyProperties);
+    vk.vkGetPhysicalDeviceQueueFamilyProperties(physicalDevices[usedPhysicalDevice], &pQueueFamilyPropertyCount, pQueueFamilyProperties);
 
     /*
-     * Get pQueueFamilyIndex
+     * Get graphics queue family index
      */
-    uint32_t pQueueFamilyIndex;
-    //True if pQueueFamilyIndex was found
-    bool foundPQueueFamilyIndex = false;
-    //searching for a fitting pQueueFamilyIndex
-    for (int i = 0; i < pQueueFamilyPropertyCount; ++i) {
+    //True if graphics queue family was found
+    bool foundGraphicsQueueFamily = false;
+    //searching for a fitting graphics queue family
+    for (uint32_t i = 0; i < pQueueFamilyPropertyCount; ++i) {
         if(pQueueFamilyProperties[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
-            pQueueFamilyIndex = i;
-            foundPQueueFamilyIndex = true;
+            graphicsQueueFamilyIndex = i;
+            foundGraphicsQueueFamily = true;
+            break;
         }
     }
-    //Trough error if no pQueueFamilyIndex was found
-    if(!foundPQueueFamilyIndex) {
-        std::cout << PPGL::Exception("Vulkan.cpp", 172, "-",
+    //Trough error if no graphics queue family was found
+    if(!foundGraphicsQueueFamily) {
+        std::cout << PPGL::Exception("Vulkan.cpp", __LINE__, "-",
                                      "Unable to find pQueueFamilyIndex");
         throw std::runtime_error("Unable to find pQueueFamilyIndex!");
     }
 
     /*
-     * Create pQueueCreateInfo
+     * Get compute queue family index
+     */
+    //True if compute queue family was found
+    bool foundComputeQueueFamily = false;
+    computeQueueIndex = 0;
+    //Prefer a compute family without graphics, so compute work can overlap with graphics
+    for (uint32_t i = 0; i < pQueueFamilyPropertyCount; ++i) {
+        if((pQueueFamilyProperties[i].queueFlags & VK_QUEUE_COMPUTE_BIT) &&
+           !(pQueueFamilyProperties[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+            computeQueueFamilyIndex = i;
+            foundComputeQueueFamily = true;
+            break;
+        }
+    }
+    //Otherwise use the graphics family, with a second queue if there is one
+    if(!foundComputeQueueFamily &&
+       (pQueueFamilyProperties[graphicsQueueFamilyIndex].queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+        computeQueueFamilyIndex = graphicsQueueFamilyIndex;
+        foundComputeQueueFamily = true;
+        if(pQueueFamilyProperties[graphicsQueueFamilyIndex].queueCount > 1) {
+            computeQueueIndex = 1;
+        }
+    }
+    //Otherwise use any family supporting compute
+    for (uint32_t i = 0; i < pQueueFamilyPropertyCount && !foundComputeQueueFamily; ++i) {
+        if(pQueueFamilyProperties[i].queueFlags & VK_QUEUE_COMPUTE_BIT) {
+            computeQueueFamilyIndex = i;
+            foundComputeQueueFamily = true;
+        }
+    }
+    //Trough error if no compute queue family was found
+    if(!foundComputeQueueFamily) {
+        std::cout << PPGL::Exception("Vulkan.cpp", __LINE__, "-",
+                                     "Unable to find compute queue family");
+        throw std::runtime_error("Unable to find compute queue family!");
+    }
+
+    /*
+     * Create pQueueCreateInfos
      */
-    //Specifying priorities of work that will be submitted to each created queue
-    float queue_priorities[1] = {0.0};
-    //create pQueueCreateInfo
-    pQueueCreateInfo = {
+    //create graphics queue create info, also covers the compute queue if it is in the same family
+    pQueueCreateInfos[0] = {
             VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
             nullptr,
             0,
-            pQueueFamilyIndex,
-            1,
-            queue_priorities
+            graphicsQueueFamilyIndex,
+            computeQueueIndex + 1,
+            queuePriorities
     };
+    pQueueCreateInfoCount = 1;
+
+    //create compute queue create info for a dedicated compute family
+    if(computeQueueFamilyIndex != graphicsQueueFamilyIndex) {
+        pQueueCreateInfos[1] = {
+                VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+                nullptr,
+                0,
+                computeQueueFamilyIndex,
+                1,
+                &queuePriorities[1]
+        };
+        pQueueCreateInfoCount = 2;
+    }
 }
 
 void PPGL::Vulkan::createLogicalDevice() {
     VkResult errorDescription;
 
+    //Get the extensions of the used physical device
+    uint32_t availableExtensionCount = 0;
+    vk.vkEnumerateDeviceExtensionProperties(physicalDevices[usedPhysicalDevice], nullptr,
+                                            &availableExtensionCount, nullptr);
+    std::vector<VkExtensionProperties> availableExtensions(availableExtensionCount);
+    vk.vkEnumerateDeviceExtensionProperties(physicalDevices[usedPhysicalDevice], nullptr,
+                                            &availableExtensionCount, availableExtensions.data());
+
     //Set pCreateInfo if no custom is used
     if(!customDeviceCreateInfo) {
+        //Memory budget, needs vkGetPhysicalDeviceMemoryProperties2KHR of the instance
+        deviceExtensions.clear();
+        if(physicalDeviceProperties2Enabled &&
+           containsExtension(availableExtensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+            deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+
+        //Indirect draws with a GPU written draw count
+        if(containsExtension(availableExtensions, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME)) {
+            deviceExtensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+        }
+
+        //Features for GPU driven rendering, enabled if supported
+        VkPhysicalDeviceFeatures supportedFeatures;
+        vk.vkGetPhysicalDeviceFeatures(physicalDevices[usedPhysicalDevice], &supportedFeatures);
+        enabledFeatures = {};
+        enabledFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+        enabledFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+
         pDeviceCreateInfo = {
                 VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO, //type of this structure
                 nullptr,                              //NULL or a pointer to a structure extending this structure
                 0,                                     //reserved for future use
-                1,                        //unsigned integer size of the pQueueCreateInfos array
-                &pQueueCreateInfo,                         //pointer to an array of VkDeviceQueueCreateInfo structures
+                pQueueCreateInfoCount,    //unsigned integer size of the pQueueCreateInfos array
+                pQueueCreateInfos,                         //pointer to an array of VkDeviceQueueCreateInfo structures
                 0,                          //deprecated and ignored
                 nullptr,                  //deprecated and ignored
-                0,                       //number of device extensions to enable
-                nullptr,               //pointer to an array of enabledExtensionCount
-                nullptr                      //pointer to a VkPhysicalDeviceFeatures
+                uint32_t(deviceExtensions.size()),  //number of device extensions to enable
+                deviceExtensions.data(),           //pointer to an array of enabledExtensionCount
+                &enabledFeatures                    //pointer to a VkPhysicalDeviceFeatures
         };
     }
 
     //Create logical device
-    errorDescription = vkCreateDevice(physicalDevices[0], &pDeviceCreateInfo, pAllocator, &pDevice);
+    errorDescription = vk.vkCreateDevice(physicalDevices[usedPhysicalDevice], &pDeviceCreateInfo, pAllocator, &pDevice);
     //Error checking
     if (errorDescription != VK_SUCCESS) {
         std::cout << PPGL::Exception("Vulkan.cpp", 185, "vkCreateDevice()",
                                      ("VkResult: " + std::to_string(int(errorDescription))).c_str());
         throw std::runtime_error("Failed to create logical device!");
     }
+
+    //Load the device functions, calls no longer go through the loader
+    vk.loadDeviceFunctions(pDevice);
+
+    //Check which of the optional extensions got enabled
+    memoryBudgetEnabled = physicalDeviceProperties2Enabled &&
+                          containsExtension(pDeviceCreateInfo.ppEnabledExtensionNames,
+                                            pDeviceCreateInfo.enabledExtensionCount,
+                                            VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    drawIndirectCountEnabled = vk.vkCmdDrawIndexedIndirectCountKHR != nullptr &&
+                               containsExtension(pDeviceCreateInfo.ppEnabledExtensionNames,
+                                                 pDeviceCreateInfo.enabledExtensionCount,
+                                                 VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+    //Custom deviceCreateInfos decide the features themselves
+    if(customDeviceCreateInfo) {
+        enabledFeatures = pDeviceCreateInfo.pEnabledFeatures != nullptr ? *pDeviceCreateInfo.pEnabledFeatures
+                                                                        : VkPhysicalDeviceFeatures{};
+    }
+
+    //Custom deviceCreateInfos decide which queues exist
+    if(customDeviceCreateInfo) {
+        getCustomDeviceQueueFamilies();
+    }
+
+    //Get the graphics and compute queue
+    vk.vkGetDeviceQueue(pDevice, graphicsQueueFamilyIndex, 0, &graphicsQueue);
+    vk.vkGetDeviceQueue(pDevice, computeQueueFamilyIndex, computeQueueIndex, &computeQueue);
+
+    //Get memory properties, needed to allocate buffers
+    vk.vkGetPhysicalDeviceMemoryProperties(physicalDevices[usedPhysicalDevice], &memoryProperties);
+}
+
+void PPGL::Vulkan::getCustomDeviceQueueFamilies() {
+    const VkDeviceQueueCreateInfo *queueCreateInfos = pDeviceCreateInfo.pQueueCreateInfos;
+    uint32_t queueCreateInfoCount = pDeviceCreateInfo.queueCreateInfoCount;
+
+    //Every created family has to exist
+    for (uint32_t i = 0; i < queueCreateInfoCount; ++i) {
+        if(queueCreateInfos[i].queueFamilyIndex >= pQueueFamilyPropertyCount || queueCreateInfos[i].queueCount == 0) {
+            std::cout << PPGL::Exception("Vulkan.cpp", __LINE__, "-",
+                                         "Invalid queue create info in custom deviceCreateInfo");
+            throw std::runtime_error("Invalid custom queue create info!");
+        }
+    }
+
+    //Graphics uses the first created graphics family
+    const VkDeviceQueueCreateInfo *graphicsQueueCreateInfo = nullptr;
+    for (uint32_t i = 0; i < queueCreateInfoCount && graphicsQueueCreateInfo == nullptr; ++i) {
+        if(pQueueFamilyProperties[queueCreateInfos[i].queueFamilyIndex].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+            graphicsQueueCreateInfo = &queueCreateInfos[i];
+        }
+    }
+    if(graphicsQueueCreateInfo == nullptr) {
+        std::cout << PPGL::Exception("Vulkan.cpp", __LINE__, "-",
+                                     "No graphics queue in custom deviceCreateInfo");
+        throw std::runtime_error("Unable to find pQueueFamilyIndex!");
+    }
+    graphicsQueueFamilyIndex = graphicsQueueCreateInfo->queueFamilyIndex;
+
+    //Compute prefers a created compute family without graphics
+    const VkDeviceQueueCreateInfo *computeQueueCreateInfo = nullptr;
+    for (uint32_t i = 0; i < queueCreateInfoCount && computeQueueCreateInfo == nullptr; ++i) {
+        VkQueueFlags queueFlags = pQueueFamilyProperties[queueCreateInfos[i].queueFamilyIndex].queueFlags;
+        if((queueFlags & VK_QUEUE_COMPUTE_BIT) && !(queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+            computeQueueCreateInfo = &queueCreateInfos[i];
+        }
+    }
+    //Otherwise shares the graphics family, using a second queue only if one got created
+    if(computeQueueCreateInfo == nullptr &&
+       (pQueueFamilyProperties[graphicsQueueFamilyIndex].queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+        computeQueueFamilyIndex = graphicsQueueFamilyIndex;
+        computeQueueIndex = graphicsQueueCreateInfo->queueCount > 1 ? 1 : 0;
+        return;
+    }
+    //Otherwise any created compute family
+    for (uint32_t i = 0; i < queueCreateInfoCount && computeQueueCreateInfo == nullptr; ++i) {
+        if(pQueueFamilyProperties[queueCreateInfos[i].queueFamilyIndex].queueFlags & VK_QUEUE_COMPUTE_BIT) {
+            computeQueueCreateInfo = &queueCreateInfos[i];
+        }
+    }
+    if(computeQueueCreateInfo == nullptr) {
+        std::cout << PPGL::Exception("Vulkan.cpp", __LINE__, "-",
+                                     "No compute queue in custom deviceCreateInfo");
+        throw std::runtime_error("Unable to find compute queue family!");
+    }
+    computeQueueFamilyIndex = computeQueueCreateInfo->queueFamilyIndex;
+    computeQueueIndex = 0;
+}
+
+uint32_t PPGL::Vulkan::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const {
+    //search for the first allowed memory type with all required properties
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+        if((typeFilter & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+
+    std::cout << PPGL::Exception("Vulkan.cpp", __LINE__, "findMemoryType()", "No fitting memory type");
+    throw std::runtime_error("Failed to find fitting memory type!");
+}
+
+void PPGL::Vulkan::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                                VkBuffer &buffer, VkDeviceMemory &memory) const {
+    VkResult errorDescription;
+
+    //Share buffer between graphics and compute family, if they differ
+    uint32_t queueFamilyIndices[2] = {graphicsQueueFamilyIndex, computeQueueFamilyIndex};
+    bool shared = graphicsQueueFamilyIndex != computeQueueFamilyIndex;
+
+    VkBufferCreateInfo bufferCreateInfo = {
+            VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            nullptr,
+            0,
+            size,
+            usage,
+            shared ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+            shared ? 2u : 0u,
+            shared ? queueFamilyIndices : nullptr
+    };
+
+    //Create buffer
+    errorDescription = vk.vkCreateBuffer(pDevice, &bufferCreateInfo, pAllocator, &buffer);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("Vulkan.cpp", __LINE__, "vkCreateBuffer()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create buffer!");
+    }
+
+    //Allocate memory that fits the buffer
+    VkMemoryRequirements memoryRequirements;
+    vk.vkGetBufferMemoryRequirements(pDevice, buffer, &memoryRequirements);
+
+    VkMemoryAllocateInfo memoryAllocateInfo = {
+            VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            nullptr,
+            memoryRequirements.size,
+            findMemoryType(memoryRequirements.memoryTypeBits, properties)
+    };
+
+    errorDescription = vk.vkAllocateMemory(pDevice, &memoryAllocateInfo, pAllocator, &memory);
+    if(errorDescription != VK_SUCCESS) {
+        vk.vkDestroyBuffer(pDevice, buffer, pAllocator);
+        std::cout << PPGL::Exception("Vulkan.cpp", __LINE__, "vkAllocateMemory()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to allocate buffer memory!");
+    }
+
+    vk.vkBindBufferMemory(pDevice, buffer, memory, 0);
+}
+
+bool PPGL::Vulkan::getMemoryBudget(VkDeviceSize *heapBudgets, VkDeviceSize *heapUsages) const {
+    if(!memoryBudgetEnabled) {
+        return false;
+    }
+
+    //Chain the budget into the memory properties query
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+    budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+    VkPhysicalDeviceMemoryProperties2 properties{};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    properties.pNext = &budgetProperties;
+    vk.vkGetPhysicalDeviceMemoryProperties2KHR(physicalDevices[usedPhysicalDevice], &properties);
+
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; ++i) {
+        heapBudgets[i] = budgetProperties.heapBudget[i];
+        heapUsages[i] = budgetProperties.heapUsage[i];
+    }
+
+    return true;
+}
+
+void PPGL::Vulkan::destroyBuffer(VkBuffer buffer, VkDeviceMemory memory) const {
+    vk.vkDestroyBuffer(pDevice, buffer, pAllocator);
+    vk.vkFreeMemory(pDevice, memory, pAllocator);
+}
+
+void PPGL::Vulkan::createImage(uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage,
+                               VkImage &image, VkDeviceMemory &memory) const {
+    VkResult errorDescription;
+
+    VkImageCreateInfo imageCreateInfo = {
+            VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            nullptr,
+            0,
+            VK_IMAGE_TYPE_2D,
+            format,
+            {width, height, 1},
+            1,
+            1,
+            VK_SAMPLE_COUNT_1_BIT,
+            VK_IMAGE_TILING_OPTIMAL,
+            usage,
+            VK_SHARING_MODE_EXCLUSIVE,
+            0,
+            nullptr,
+            VK_IMAGE_LAYOUT_UNDEFINED
+    };
+
+    //Create image
+    errorDescription = vk.vkCreateImage(pDevice, &imageCreateInfo, pAllocator, &image);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("Vulkan.cpp", __LINE__, "vkCreateImage()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create image!");
+    }
+
+    //Allocate memory that fits the image
+    VkMemoryRequirements memoryRequirements;
+    vk.vkGetImageMemoryRequirements(pDevice, image, &memoryRequirements);
+
+    VkMemoryAllocateInfo memoryAllocateInfo = {
+            VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            nullptr,
+            memoryRequirements.size,
+            findMemoryType(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+    };
+
+    errorDescription = vk.vkAllocateMemory(pDevice, &memoryAllocateInfo, pAllocator, &memory);
+    if(errorDescription != VK_SUCCESS) {
+        vk.vkDestroyImage(pDevice, image, pAllocator);
+        std::cout << PPGL::Exception("Vulkan.cpp", __LINE__, "vkAllocateMemory()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to allocate image memory!");
+    }
+
+    vk.vkBindImageMemory(pDevice, image, memory, 0);
+}
+
+void PPGL::Vulkan::destroyImage(VkImage image, VkDeviceMemory memory) const {
+    vk.vkDestroyImage(pDevice, image, pAllocator);
+    vk.vkFreeMemory(pDevice, memory, pAllocator);
+}
+
+VkShaderModule PPGL::Vulkan::createShaderModule(const uint32_t *code, size_t size) const {
+    VkShaderModuleCreateInfo shaderModuleCreateInfo = {
+            VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+            nullptr,
+            0,
+            size,
+            code
+    };
+
+    VkShaderModule shaderModule;
+    VkResult errorDescription = vk.vkCreateShaderModule(pDevice, &shaderModuleCreateInfo, pAllocator, &shaderModule);
+    if(errorDescription != VK_SUCCESS) {
+        std::cout << PPGL::Exception("Vulkan.cpp", __LINE__, "vkCreateShaderModule()",
+                                     ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+        throw std::runtime_error("Failed to create shader module!");
+    }
+
+    return shaderModule;
 }
 
 void PPGL::Vulkan::setCustomAppInfo(VkApplicationInfo appInfo, VkInstanceCreateInfo instanceCreateInfo) {
@@ -206,7 +579,13 @@ void PPGL::Vulkan::setCustomDeviceCreateInfo(VkDeviceCreateInfo deviceCreateInfo
 
 PPGL::Vulkan::~Vulkan() {
     //Destroy logical device
-    vkDestroyDevice(pDevice, pAllocator);
+    if(pDevice != VK_NULL_HANDLE) {
+        vk.vkDestroyDevice(pDevice, pAllocator);
+    }
     //Destroy instance for appInfo
-    vkDestroyInstance(instance, nullptr);
+    if(instance != VK_NULL_HANDLE) {
+        vk.vkDestroyInstance(instance, nullptr);
+    }
+    //Unload the Vulkan library, if it got loaded at runtime
+    vk.unload();
 }
@@ -29,8 +29,10 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 #include <string>
+#include <vector>
 
 #include "PPGL_Exception.h"
+#include "VulkanDispatch.h"
 
 #ifndef PPGL_VULKAN_H
 #define PPGL_VULKAN_H
@@ -74,7 +76,8 @@ namespace PPGL {
         ///
         /// \brief -
         /// \brief Overwrites the standard deviceCreateInfo to the custom deviceCreateInfo.
-        /// \brief Has to be called before init.
+        /// \brief Has to be called before init. Its pQueueCreateInfos need a graphics queue,
+        /// \brief compute work shares it if no other compute capable queue is created.
         /// \brief -
         ///
         /// \param deviceCreateInfo The custom deviceCreateInfo.
@@ -82,6 +85,133 @@ namespace PPGL {
         ////////////////////////////////////////////////////////////////
         void setCustomDeviceCreateInfo(VkDeviceCreateInfo deviceCreateInfo);
 
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Finds a memory type of the used physical device.
+        /// \brief -
+        ///
+        /// \param typeFilter Bitmask of the allowed memory types.
+        /// \param properties The required memory property flags.
+        ///
+        /// \return uint32_t
+        /// \return The index of the memory type
+        ///
+        ////////////////////////////////////////////////////////////////
+        uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Creates a buffer and binds newly allocated memory to it.
+        /// \brief If graphics and compute use different queue families
+        /// \brief the buffer is shared concurrently between both.
+        /// \brief -
+        ///
+        /// \param size The size of the buffer in bytes.
+        /// \param usage The usage flags of the buffer.
+        /// \param properties The required memory property flags.
+        /// \param buffer Receives the created buffer.
+        /// \param memory Receives the memory bound to the buffer.
+        ///
+        ////////////////////////////////////////////////////////////////
+        void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                          VkBuffer &buffer, VkDeviceMemory &memory) const;
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Destroys a buffer created by createBuffer and frees its memory.
+        /// \brief -
+        ///
+        /// \param buffer The buffer to destroy.
+        /// \param memory The memory to free.
+        ///
+        ////////////////////////////////////////////////////////////////
+        void destroyBuffer(VkBuffer buffer, VkDeviceMemory memory) const;
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Creates a 2D image with one mip level and optimal tiling
+        /// \brief and binds newly allocated device local memory to it.
+        /// \brief The image is owned by the graphics queue family.
+        /// \brief -
+        ///
+        /// \param width The width of the image in pixels.
+        /// \param height The height of the image in pixels.
+        /// \param format The format of the image.
+        /// \param usage The usage flags of the image.
+        /// \param image Receives the created image.
+        /// \param memory Receives the memory bound to the image.
+        ///
+        ////////////////////////////////////////////////////////////////
+        void createImage(uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage,
+                         VkImage &image, VkDeviceMemory &memory) const;
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Destroys an image created by createImage and frees its memory.
+        /// \brief -
+        ///
+        /// \param image The image to destroy.
+        /// \param memory The memory to free.
+        ///
+        ////////////////////////////////////////////////////////////////
+        void destroyImage(VkImage image, VkDeviceMemory memory) const;
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Reads the memory budget and usage of every heap of the process
+        /// \brief from VK_EXT_memory_budget.
+        /// \brief -
+        ///
+        /// \param heapBudgets Receives the budget of each heap, needs room for VK_MAX_MEMORY_HEAPS values.
+        /// \param heapUsages Receives the usage of each heap, needs room for VK_MAX_MEMORY_HEAPS values.
+        ///
+        /// \return bool
+        /// \return TRUE if the budget got read
+        /// \return FALSE if VK_EXT_memory_budget is not enabled
+        ///
+        ////////////////////////////////////////////////////////////////
+        bool getMemoryBudget(VkDeviceSize *heapBudgets, VkDeviceSize *heapUsages) const;
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Creates a shader module from SPIR-V code.
+        /// \brief -
+        ///
+        /// \param code Pointer to the SPIR-V words.
+        /// \param size The size of the code in bytes.
+        ///
+        /// \return VkShaderModule
+        ///
+        ////////////////////////////////////////////////////////////////
+        VkShaderModule createShaderModule(const uint32_t *code, size_t size) const;
+
+        //Getters
+        const VulkanDispatch &getDispatch() const { return vk; }
+        VkDevice getDevice() const { return pDevice; }
+        VkPhysicalDevice getPhysicalDevice() const { return physicalDevices[usedPhysicalDevice]; }
+        const VkPhysicalDeviceProperties &getPhysicalDeviceProperties() const {
+            return physicalDeviceProperties[usedPhysicalDevice];
+        }
+        const VkAllocationCallbacks *getAllocator() const { return pAllocator; }
+        const VkPhysicalDeviceMemoryProperties &getMemoryProperties() const { return memoryProperties; }
+        bool hasMemoryBudget() const { return memoryBudgetEnabled; }
+        bool hasDrawIndirectCount() const { return drawIndirectCountEnabled; }
+        const VkPhysicalDeviceFeatures &getEnabledFeatures() const { return enabledFeatures; }
+
+        VkQueue getGraphicsQueue() const { return graphicsQueue; }
+        uint32_t getGraphicsQueueFamilyIndex() const { return graphicsQueueFamilyIndex; }
+        VkQueue getComputeQueue() const { return computeQueue; }
+        uint32_t getComputeQueueFamilyIndex() const { return computeQueueFamilyIndex; }
+        //True if compute work is submitted to a different queue than graphics work
+        bool hasAsyncCompute() const { return computeQueue != graphicsQueue; }
+
     private:
 
         ////////////////////////////////////////////////////////////////
@@ -105,7 +235,8 @@ namespace PPGL {
         ////////////////////////////////////////////////////////////////
         ///
         /// \brief -
-        /// \brief Gets the queue create info
+        /// \brief Gets the queue create infos for a graphics queue
+        /// \brief and a compute queue, preferring a dedicated compute family
         /// \brief -
         ///
         ////////////////////////////////////////////////////////////////
@@ -120,9 +251,23 @@ namespace PPGL {
         ////////////////////////////////////////////////////////////////
         void createLogicalDevice();
 
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Picks the graphics and compute queue of a custom deviceCreateInfo
+        /// \brief from its pQueueCreateInfos, compute shares the graphics queue
+        /// \brief if no other compute queue got created
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void getCustomDeviceQueueFamilies();
+
         //stores glfw error descriptions
         const char *description = nullptr;
 
+        //Vulkan functions, used instead of the loader's exported functions
+        VulkanDispatch vk;
+
         //Vulkan instance
         VkInstance instance{};
 
@@ -131,6 +276,10 @@ namespace PPGL {
         bool customAppInfo = false;
         //Info for creating an Instance
         VkInstanceCreateInfo instanceCreateInfo{};
+        //Instance extensions enabled if no custom appInfo is used
+        std::vector<const char *> instanceExtensions;
+        //True if VK_KHR_get_physical_device_properties2 is enabled
+        bool physicalDeviceProperties2Enabled = false;
 
         //The number of global extensions to enable
         uint32_t glfwExtensionCount = 0;
@@ -154,16 +303,39 @@ namespace PPGL {
 
         VkQueueFamilyProperties *pQueueFamilyProperties;
         //Pointer to an array of VkQueueFamilyProperties structures
-        VkDeviceQueueCreateInfo pQueueCreateInfo = {};
+        //One entry for graphics and, if compute uses its own family, one for compute
+        VkDeviceQueueCreateInfo pQueueCreateInfos[2] = {};
+        uint32_t pQueueCreateInfoCount = 0;
+        //Specifying priorities of work that will be submitted to each created queue
+        float queuePriorities[2] = {1.0f, 1.0f};
+
+        //Queue family and queue index used for graphics and compute
+        uint32_t graphicsQueueFamilyIndex = 0;
+        uint32_t computeQueueFamilyIndex = 0;
+        uint32_t computeQueueIndex = 0;
+        //Queues, retrieved after the logical device got created
+        VkQueue graphicsQueue = VK_NULL_HANDLE;
+        VkQueue computeQueue = VK_NULL_HANDLE;
 
         //Logical devices
         //Contains information about how to create the device
         VkDeviceCreateInfo pDeviceCreateInfo = {};
         bool customDeviceCreateInfo = false;
+        //Device extensions enabled if no custom deviceCreateInfo is used
+        std::vector<const char *> deviceExtensions;
+        //True if VK_EXT_memory_budget is enabled
+        bool memoryBudgetEnabled = false;
+        //True if VK_KHR_draw_indirect_count is enabled
+        bool drawIndirectCountEnabled = false;
+        //Features enabled on the logical device
+        VkPhysicalDeviceFeatures enabledFeatures{};
         //Controls host memory allocation
-        const VkAllocationCallbacks *pAllocator;
+        const VkAllocationCallbacks *pAllocator = nullptr;
         //Logical device
-        VkDevice pDevice;
+        VkDevice pDevice = VK_NULL_HANDLE;
+
+        //Memory properties of the used physical device
+        VkPhysicalDeviceMemoryProperties memoryProperties{};
     };
 }
 
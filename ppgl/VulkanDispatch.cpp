@@ -0,0 +1,133 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "VulkanDispatch.h"
+#include "PPGL_Exception.h"
+
+#ifdef PPGL_VULKAN_DYNAMIC_LOADING
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+#endif
+
+//Prints and throws an exception if a function could not be loaded
+static void checkFunction(void (*function)(), const char *name) {
+    if(function == nullptr) {
+        std::cout << PPGL::Exception("VulkanDispatch.cpp", __LINE__, name, "Unable to load function");
+        throw std::runtime_error(std::string("Failed to load ") + name + "!");
+    }
+}
+
+void PPGL::VulkanDispatch::loadGlobalFunctions() {
+#ifdef PPGL_VULKAN_DYNAMIC_LOADING
+    //Load the Vulkan library instead of linking to it
+#if defined(_WIN32)
+    HMODULE module = LoadLibraryA("vulkan-1.dll");
+    library = reinterpret_cast<void *>(module);
+    if(module != nullptr) {
+        vkGetInstanceProcAddr = reinterpret_cast<PFN_vkGetInstanceProcAddr>(
+                GetProcAddress(module, "vkGetInstanceProcAddr"));
+    }
+#else
+#if defined(__APPLE__)
+    const char *libraryNames[] = {"libvulkan.1.dylib", "libvulkan.dylib", "libMoltenVK.dylib"};
+#else
+    const char *libraryNames[] = {"libvulkan.so.1", "libvulkan.so"};
+#endif
+    for (const char *libraryName : libraryNames) {
+        library = dlopen(libraryName, RTLD_NOW | RTLD_LOCAL);
+        if(library != nullptr) {
+            break;
+        }
+    }
+    if(library != nullptr) {
+        vkGetInstanceProcAddr = reinterpret_cast<PFN_vkGetInstanceProcAddr>(dlsym(library, "vkGetInstanceProcAddr"));
+    }
+#endif
+    if(library == nullptr) {
+        std::cout << PPGL::Exception("VulkanDispatch.cpp", __LINE__, "loadGlobalFunctions()",
+                                     "Unable to load the Vulkan library");
+        throw std::runtime_error("Failed to load the Vulkan library!");
+    }
+#else
+    vkGetInstanceProcAddr = ::vkGetInstanceProcAddr;
+#endif
+    checkFunction(reinterpret_cast<void (*)()>(vkGetInstanceProcAddr), "vkGetInstanceProcAddr");
+
+#define PPGL_VULKAN_LOAD_FUNCTION(name) \
+    name = reinterpret_cast<PFN_##name>(vkGetInstanceProcAddr(nullptr, #name)); \
+    checkFunction(reinterpret_cast<void (*)()>(name), #name);
+    PPGL_VULKAN_GLOBAL_FUNCTIONS(PPGL_VULKAN_LOAD_FUNCTION)
+#undef PPGL_VULKAN_LOAD_FUNCTION
+}
+
+void PPGL::VulkanDispatch::loadInstanceFunctions(VkInstance instance) {
+#define PPGL_VULKAN_LOAD_FUNCTION(name) \
+    name = reinterpret_cast<PFN_##name>(vkGetInstanceProcAddr(instance, #name)); \
+    checkFunction(reinterpret_cast<void (*)()>(name), #name);
+    PPGL_VULKAN_INSTANCE_FUNCTIONS(PPGL_VULKAN_LOAD_FUNCTION)
+#undef PPGL_VULKAN_LOAD_FUNCTION
+
+    //Optional functions stay nullptr if they are not available
+#define PPGL_VULKAN_LOAD_FUNCTION(name) \
+    name = reinterpret_cast<PFN_##name>(vkGetInstanceProcAddr(instance, #name));
+    PPGL_VULKAN_OPTIONAL_INSTANCE_FUNCTIONS(PPGL_VULKAN_LOAD_FUNCTION)
+#undef PPGL_VULKAN_LOAD_FUNCTION
+}
+
+void PPGL::VulkanDispatch::loadDeviceFunctions(VkDevice device) {
+#define PPGL_VULKAN_LOAD_FUNCTION(name) \
+    name = reinterpret_cast<PFN_##name>(vkGetDeviceProcAddr(device, #name)); \
+    checkFunction(reinterpret_cast<void (*)()>(name), #name);
+    PPGL_VULKAN_DEVICE_FUNCTIONS(PPGL_VULKAN_LOAD_FUNCTION)
+#undef PPGL_VULKAN_LOAD_FUNCTION
+
+    //Optional functions stay nullptr if their extension is not enabled
+#define PPGL_VULKAN_LOAD_FUNCTION(name) \
+    name = reinterpret_cast<PFN_##name>(vkGetDeviceProcAddr(device, #name));
+    PPGL_VULKAN_OPTIONAL_DEVICE_FUNCTIONS(PPGL_VULKAN_LOAD_FUNCTION)
+#undef PPGL_VULKAN_LOAD_FUNCTION
+}
+
+void PPGL::VulkanDispatch::unload() {
+#ifdef PPGL_VULKAN_DYNAMIC_LOADING
+    if(library != nullptr) {
+#ifdef _WIN32
+        FreeLibrary(reinterpret_cast<HMODULE>(library));
+#else
+        dlclose(library);
+#endif
+        library = nullptr;
+    }
+#endif
+}
@@ -0,0 +1,223 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+#ifndef PPGL_VULKANDISPATCH_H
+#define PPGL_VULKANDISPATCH_H
+
+/*
+ * Headers
+ */
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+/*
+ * Function lists, every entry becomes a member of VulkanDispatch.
+ * Add a function to the list matching the level it is loaded at.
+ */
+//Loaded with vkGetInstanceProcAddr and no instance
+#define PPGL_VULKAN_GLOBAL_FUNCTIONS(X) \
+    X(vkCreateInstance) \
+    X(vkEnumerateInstanceExtensionProperties) \
+    X(vkEnumerateInstanceLayerProperties)
+
+//Loaded with vkGetInstanceProcAddr and the instance
+#define PPGL_VULKAN_INSTANCE_FUNCTIONS(X) \
+    X(vkDestroyInstance) \
+    X(vkEnumeratePhysicalDevices) \
+    X(vkGetPhysicalDeviceFeatures) \
+    X(vkGetPhysicalDeviceProperties) \
+    X(vkGetPhysicalDeviceQueueFamilyProperties) \
+    X(vkGetPhysicalDeviceMemoryProperties) \
+    X(vkEnumerateDeviceExtensionProperties) \
+    X(vkCreateDevice) \
+    X(vkGetDeviceProcAddr)
+
+//Loaded with vkGetInstanceProcAddr and the instance, nullptr if the extension is not available
+#define PPGL_VULKAN_OPTIONAL_INSTANCE_FUNCTIONS(X) \
+    X(vkGetPhysicalDeviceMemoryProperties2KHR)
+
+//Loaded with vkGetDeviceProcAddr and the logical device, bypassing the loader trampolines
+#define PPGL_VULKAN_DEVICE_FUNCTIONS(X) \
+    X(vkDestroyDevice) \
+    X(vkGetDeviceQueue) \
+    X(vkDeviceWaitIdle) \
+    X(vkQueueSubmit) \
+    X(vkQueueWaitIdle) \
+    X(vkAllocateMemory) \
+    X(vkFreeMemory) \
+    X(vkMapMemory) \
+    X(vkUnmapMemory) \
+    X(vkFlushMappedMemoryRanges) \
+    X(vkInvalidateMappedMemoryRanges) \
+    X(vkBindBufferMemory) \
+    X(vkBindImageMemory) \
+    X(vkGetBufferMemoryRequirements) \
+    X(vkGetImageMemoryRequirements) \
+    X(vkCreateFence) \
+    X(vkDestroyFence) \
+    X(vkResetFences) \
+    X(vkGetFenceStatus) \
+    X(vkWaitForFences) \
+    X(vkCreateSemaphore) \
+    X(vkDestroySemaphore) \
+    X(vkCreateQueryPool) \
+    X(vkDestroyQueryPool) \
+    X(vkGetQueryPoolResults) \
+    X(vkCreateBuffer) \
+    X(vkDestroyBuffer) \
+    X(vkCreateImage) \
+    X(vkDestroyImage) \
+    X(vkCreateImageView) \
+    X(vkDestroyImageView) \
+    X(vkCreateSampler) \
+    X(vkDestroySampler) \
+    X(vkCreateShaderModule) \
+    X(vkDestroyShaderModule) \
+    X(vkCreateGraphicsPipelines) \
+    X(vkCreateComputePipelines) \
+    X(vkDestroyPipeline) \
+    X(vkCreatePipelineLayout) \
+    X(vkDestroyPipelineLayout) \
+    X(vkCreateDescriptorSetLayout) \
+    X(vkDestroyDescriptorSetLayout) \
+    X(vkCreateDescriptorPool) \
+    X(vkDestroyDescriptorPool) \
+    X(vkResetDescriptorPool) \
+    X(vkAllocateDescriptorSets) \
+    X(vkFreeDescriptorSets) \
+    X(vkUpdateDescriptorSets) \
+    X(vkCreateFramebuffer) \
+    X(vkDestroyFramebuffer) \
+    X(vkCreateRenderPass) \
+    X(vkDestroyRenderPass) \
+    X(vkCreateCommandPool) \
+    X(vkDestroyCommandPool) \
+    X(vkResetCommandPool) \
+    X(vkAllocateCommandBuffers) \
+    X(vkFreeCommandBuffers) \
+    X(vkBeginCommandBuffer) \
+    X(vkEndCommandBuffer) \
+    X(vkResetCommandBuffer) \
+    X(vkCmdBindPipeline) \
+    X(vkCmdSetViewport) \
+    X(vkCmdSetScissor) \
+    X(vkCmdBindDescriptorSets) \
+    X(vkCmdBindIndexBuffer) \
+    X(vkCmdBindVertexBuffers) \
+    X(vkCmdDraw) \
+    X(vkCmdDrawIndexed) \
+    X(vkCmdDrawIndirect) \
+    X(vkCmdDrawIndexedIndirect) \
+    X(vkCmdDispatch) \
+    X(vkCmdDispatchIndirect) \
+    X(vkCmdCopyBuffer) \
+    X(vkCmdCopyImage) \
+    X(vkCmdCopyBufferToImage) \
+    X(vkCmdCopyImageToBuffer) \
+    X(vkCmdUpdateBuffer) \
+    X(vkCmdFillBuffer) \
+    X(vkCmdClearColorImage) \
+    X(vkCmdPipelineBarrier) \
+    X(vkCmdResetQueryPool) \
+    X(vkCmdWriteTimestamp) \
+    X(vkCmdPushConstants) \
+    X(vkCmdBeginRenderPass) \
+    X(vkCmdNextSubpass) \
+    X(vkCmdEndRenderPass) \
+    X(vkCmdExecuteCommands)
+
+//Loaded with vkGetDeviceProcAddr and the logical device, nullptr if the extension is not enabled
+#define PPGL_VULKAN_OPTIONAL_DEVICE_FUNCTIONS(X) \
+    X(vkCmdDrawIndexedIndirectCountKHR)
+
+namespace PPGL {
+
+    ////////////////////////////////////////////////////////////////
+    ///
+    /// \brief -
+    /// \brief Table of Vulkan function pointers used by PPGL.
+    /// \brief Device functions are loaded with vkGetDeviceProcAddr,
+    /// \brief so calls go straight to the driver instead of the loader.
+    /// \brief -
+    ///
+    ////////////////////////////////////////////////////////////////
+    struct VulkanDispatch {
+        PFN_vkGetInstanceProcAddr vkGetInstanceProcAddr = nullptr;
+
+#define PPGL_VULKAN_DECLARE_FUNCTION(name) PFN_##name name = nullptr;
+        PPGL_VULKAN_GLOBAL_FUNCTIONS(PPGL_VULKAN_DECLARE_FUNCTION)
+        PPGL_VULKAN_INSTANCE_FUNCTIONS(PPGL_VULKAN_DECLARE_FUNCTION)
+        PPGL_VULKAN_OPTIONAL_INSTANCE_FUNCTIONS(PPGL_VULKAN_DECLARE_FUNCTION)
+        PPGL_VULKAN_DEVICE_FUNCTIONS(PPGL_VULKAN_DECLARE_FUNCTION)
+        PPGL_VULKAN_OPTIONAL_DEVICE_FUNCTIONS(PPGL_VULKAN_DECLARE_FUNCTION)
+#undef PPGL_VULKAN_DECLARE_FUNCTION
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Gets vkGetInstanceProcAddr and loads the global functions.
+        /// \brief With PPGL_VULKAN_DYNAMIC_LOADING the Vulkan library is loaded at runtime.
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void loadGlobalFunctions();
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Loads the instance functions.
+        /// \brief -
+        ///
+        /// \param instance The created instance.
+        ///
+        ////////////////////////////////////////////////////////////////
+        void loadInstanceFunctions(VkInstance instance);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Loads the device functions.
+        /// \brief -
+        ///
+        /// \param device The created logical device.
+        ///
+        ////////////////////////////////////////////////////////////////
+        void loadDeviceFunctions(VkDevice device);
+
+        ////////////////////////////////////////////////////////////////
+        ///
+        /// \brief -
+        /// \brief Unloads the Vulkan library, if it got loaded at runtime.
+        /// \brief -
+        ///
+        ////////////////////////////////////////////////////////////////
+        void unload();
+
+        //Handle of the Vulkan library loaded at runtime
+        void *library = nullptr;
+    };
+}
+
+#endif //PPGL_VULKANDISPATCH_H
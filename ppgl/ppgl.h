@@ -32,5 +32,11 @@
 
 #include "Window.h"
 #include "Vulkan.h"
+#include "ParticleSystem.h"
+#include "Collision.h"
+#include "ResidencyManager.h"
+#include "GpuDrivenRenderer.h"
+#include "Font.h"
+#include "TextRenderer.h"
 
 #endif //PPGL_PPGL_H
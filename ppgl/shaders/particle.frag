@@ -0,0 +1,14 @@
+#version 450
+
+layout(location = 0) in vec4 inColor;
+layout(location = 1) in vec2 inUV;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    float falloff = 1.0 - dot(inUV, inUV);
+    if (falloff <= 0.0) {
+        discard;
+    }
+    outColor = vec4(inColor.rgb, inColor.a * falloff);
+}
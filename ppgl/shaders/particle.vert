@@ -0,0 +1,31 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#define PARTICLE_ACCESS readonly
+#include "particle_common.glsl"
+
+layout(push_constant) uniform PushConstants {
+    mat4 viewProjection;
+    uint list;
+    uint maxParticles;
+    float size;
+} pc;
+
+layout(location = 0) out vec4 outColor;
+layout(location = 1) out vec2 outUV;
+
+const vec2 corners[6] = vec2[](
+    vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),
+    vec2(-1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0)
+);
+
+void main() {
+    Particle particle = particles[aliveLists[pc.list * pc.maxParticles + gl_InstanceIndex]];
+    vec2 corner = corners[gl_VertexIndex];
+
+    gl_Position = pc.viewProjection * vec4(particle.positionLife.xyz, 1.0);
+    gl_Position.xy += corner * pc.size;
+
+    outColor = particle.color;
+    outUV = corner;
+}
@@ -0,0 +1,47 @@
+/*
+ * Shared declarations of the particle compute and render shaders.
+ * Layouts have to match PPGL::ParticleSystem.
+ * Define PARTICLE_ACCESS as readonly before including in stages without store support.
+ */
+
+#ifndef PARTICLE_ACCESS
+#define PARTICLE_ACCESS
+#endif
+
+struct Particle {
+    vec4 positionLife;  //xyz: position, w: remaining life in seconds
+    vec4 velocityAge;   //xyz: velocity, w: total lifetime in seconds
+    vec4 color;
+};
+
+struct Emitter {
+    vec4 positionLifetime;  //xyz: position, w: lifetime of emitted particles
+    vec4 velocitySpread;    //xyz: base velocity, w: random velocity spread
+    vec4 color;
+    uvec4 emit;             //x: first emission slot this frame, y: emission count, z: random seed
+};
+
+layout(std430, set = 0, binding = 0) PARTICLE_ACCESS buffer Particles {
+    Particle particles[];
+};
+
+layout(std430, set = 0, binding = 1) PARTICLE_ACCESS buffer DeadList {
+    uint deadList[];
+};
+
+//Two alive lists, the list of this frame and the list of the next frame, each maxParticles long
+layout(std430, set = 0, binding = 2) PARTICLE_ACCESS buffer AliveLists {
+    uint aliveLists[];
+};
+
+layout(std430, set = 0, binding = 3) PARTICLE_ACCESS buffer Counters {
+    int deadCount;
+    uint aliveCount[2];
+    uint counterPadding;
+    uvec4 simulateDispatch;     //VkDispatchIndirectCommand
+    uvec4 draw;                 //VkDrawIndirectCommand
+};
+
+layout(std430, set = 0, binding = 4) readonly buffer Emitters {
+    Emitter emitters[];
+};
@@ -0,0 +1,8 @@
+layout(push_constant) uniform PushConstants {
+    vec4 gravityDrag;   //xyz: gravity, w: linear drag
+    float deltaTime;
+    uint current;       //alive list simulated this frame
+    uint emitTotal;
+    uint emitterCount;
+    uint maxParticles;
+} pc;
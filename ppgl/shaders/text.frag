@@ -0,0 +1,29 @@
+#version 450
+
+layout(set = 0, binding = 0) uniform sampler2D page;
+
+layout(push_constant) uniform PushConstants {
+    vec2 inverseViewportSize;
+    uint sdf;
+} pc;
+
+layout(location = 0) in vec2 inUV;
+layout(location = 1) in vec4 inColor;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    float value = texture(page, inUV).r;
+
+    float coverage = value;
+    if (pc.sdf != 0) {
+        //The outline is at 0.5, antialias over about one screen pixel at any scale
+        float width = max(fwidth(value) * 0.5, 1.0 / 255.0);
+        coverage = smoothstep(0.5 - width, 0.5 + width, value);
+    }
+
+    if (coverage <= 0.0) {
+        discard;
+    }
+    outColor = vec4(inColor.rgb, inColor.a * coverage);
+}
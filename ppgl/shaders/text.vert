@@ -0,0 +1,30 @@
+#version 450
+
+//One instance per glyph: quad in pixels, texture coordinates in the page and color
+layout(location = 0) in vec4 inRect;
+layout(location = 1) in vec4 inUV;
+layout(location = 2) in vec4 inColor;
+
+layout(push_constant) uniform PushConstants {
+    vec2 inverseViewportSize;
+    uint sdf;
+} pc;
+
+layout(location = 0) out vec2 outUV;
+layout(location = 1) out vec4 outColor;
+
+const vec2 corners[6] = vec2[](
+    vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0),
+    vec2(0.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0)
+);
+
+void main() {
+    vec2 corner = corners[gl_VertexIndex];
+    vec2 position = inRect.xy + corner * inRect.zw;
+
+    //Pixels with the origin in the top left corner to clip space
+    gl_Position = vec4(position * 2.0 * pc.inverseViewportSize - 1.0, 0.0, 1.0);
+
+    outUV = mix(inUV.xy, inUV.zw, corner);
+    outColor = inColor;
+}
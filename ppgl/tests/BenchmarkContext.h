@@ -0,0 +1,268 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+#ifndef PPGL_BENCHMARKCONTEXT_H
+#define PPGL_BENCHMARKCONTEXT_H
+
+/*
+ * Headers
+ */
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "Vulkan.h"
+
+/*
+ * SPIR-V of the benchmark vertex shader, generated at build time from tests/shaders/
+ */
+static const uint32_t benchmarkVertexCode[] =
+#include "shaders/benchmark.vert.inc"
+;
+
+////////////////////////////////////////////////////////////////
+///
+/// \brief -
+/// \brief Command buffer, render pass and pipeline to record benchmark commands into.
+/// \brief The render pass has no attachments and the pipeline discards rasterization,
+/// \brief so draws are valid while nothing gets drawn.
+/// \brief -
+///
+////////////////////////////////////////////////////////////////
+class BenchmarkContext {
+public:
+    explicit BenchmarkContext(const PPGL::Vulkan &vulkan) :
+            vulkan (vulkan), vk (vulkan.getDispatch()), device (vulkan.getDevice())
+    {
+        /*
+         * Command buffer
+         */
+        VkCommandPoolCreateInfo commandPoolCreateInfo = {
+                VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                nullptr,
+                0,
+                vulkan.getGraphicsQueueFamilyIndex()
+        };
+        check(vk.vkCreateCommandPool(device, &commandPoolCreateInfo, vulkan.getAllocator(), &commandPool),
+              "vkCreateCommandPool()");
+
+        VkCommandBufferAllocateInfo commandBufferAllocateInfo = {
+                VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                nullptr,
+                commandPool,
+                VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+                1
+        };
+        check(vk.vkAllocateCommandBuffers(device, &commandBufferAllocateInfo, &commandBuffer),
+              "vkAllocateCommandBuffers()");
+
+        VkFenceCreateInfo fenceCreateInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, nullptr, 0};
+        check(vk.vkCreateFence(device, &fenceCreateInfo, vulkan.getAllocator(), &fence), "vkCreateFence()");
+
+        /*
+         * Render pass and framebuffer without attachments
+         */
+        VkSubpassDescription subpass = {
+                0, VK_PIPELINE_BIND_POINT_GRAPHICS, 0, nullptr, 0, nullptr, nullptr, nullptr, 0, nullptr
+        };
+        VkRenderPassCreateInfo renderPassCreateInfo = {
+                VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO, nullptr, 0, 0, nullptr, 1, &subpass, 0, nullptr
+        };
+        check(vk.vkCreateRenderPass(device, &renderPassCreateInfo, vulkan.getAllocator(), &renderPass),
+              "vkCreateRenderPass()");
+
+        VkFramebufferCreateInfo framebufferCreateInfo = {
+                VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO, nullptr, 0, renderPass, 0, nullptr, 1, 1, 1
+        };
+        check(vk.vkCreateFramebuffer(device, &framebufferCreateInfo, vulkan.getAllocator(), &framebuffer),
+              "vkCreateFramebuffer()");
+
+        /*
+         * Empty descriptor set, to measure binds
+         */
+        VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = {
+                VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO, nullptr, 0, 0, nullptr
+        };
+        check(vk.vkCreateDescriptorSetLayout(device, &descriptorSetLayoutCreateInfo, vulkan.getAllocator(),
+                                             &descriptorSetLayout), "vkCreateDescriptorSetLayout()");
+
+        VkDescriptorPoolSize poolSize = {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1};
+        VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {
+                VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO, nullptr, 0, 1, 1, &poolSize
+        };
+        check(vk.vkCreateDescriptorPool(device, &descriptorPoolCreateInfo, vulkan.getAllocator(), &descriptorPool),
+              "vkCreateDescriptorPool()");
+
+        VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {
+                VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO, nullptr, descriptorPool, 1, &descriptorSetLayout
+        };
+        check(vk.vkAllocateDescriptorSets(device, &descriptorSetAllocateInfo, &descriptorSet),
+              "vkAllocateDescriptorSets()");
+
+        VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {
+                VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO, nullptr, 0, 1, &descriptorSetLayout, 0, nullptr
+        };
+        check(vk.vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, vulkan.getAllocator(), &pipelineLayout),
+              "vkCreatePipelineLayout()");
+
+        /*
+         * Vertex only pipeline, rasterization is discarded
+         */
+        VkShaderModule vertexModule = vulkan.createShaderModule(benchmarkVertexCode, sizeof(benchmarkVertexCode));
+        VkPipelineShaderStageCreateInfo stage = {
+                VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, nullptr, 0, VK_SHADER_STAGE_VERTEX_BIT,
+                vertexModule, "main", nullptr
+        };
+        VkPipelineVertexInputStateCreateInfo vertexInputState = {
+                VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO, nullptr, 0, 0, nullptr, 0, nullptr
+        };
+        VkPipelineInputAssemblyStateCreateInfo inputAssemblyState = {
+                VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO, nullptr, 0,
+                VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_FALSE
+        };
+        VkPipelineRasterizationStateCreateInfo rasterizationState = {
+                VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO, nullptr, 0, VK_FALSE, VK_TRUE,
+                VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE, VK_FALSE, 0.0f, 0.0f, 0.0f,
+                1.0f
+        };
+        VkGraphicsPipelineCreateInfo graphicsPipelineCreateInfo = {
+                VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                nullptr,
+                0,
+                1,
+                &stage,
+                &vertexInputState,
+                &inputAssemblyState,
+                nullptr,
+                nullptr,
+                &rasterizationState,
+                nullptr,
+                nullptr,
+                nullptr,
+                nullptr,
+                pipelineLayout,
+                renderPass,
+                0,
+                VK_NULL_HANDLE,
+                -1
+        };
+        VkResult errorDescription = vk.vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &graphicsPipelineCreateInfo,
+                                                                 vulkan.getAllocator(), &pipeline);
+        vk.vkDestroyShaderModule(device, vertexModule, vulkan.getAllocator());
+        check(errorDescription, "vkCreateGraphicsPipelines()");
+    }
+
+    ~BenchmarkContext() {
+        vk.vkDestroyPipeline(device, pipeline, vulkan.getAllocator());
+        vk.vkDestroyPipelineLayout(device, pipelineLayout, vulkan.getAllocator());
+        vk.vkDestroyDescriptorPool(device, descriptorPool, vulkan.getAllocator());
+        vk.vkDestroyDescriptorSetLayout(device, descriptorSetLayout, vulkan.getAllocator());
+        vk.vkDestroyFramebuffer(device, framebuffer, vulkan.getAllocator());
+        vk.vkDestroyRenderPass(device, renderPass, vulkan.getAllocator());
+        vk.vkDestroyFence(device, fence, vulkan.getAllocator());
+        vk.vkDestroyCommandPool(device, commandPool, vulkan.getAllocator());
+    }
+
+    BenchmarkContext(const BenchmarkContext &) = delete;
+    BenchmarkContext &operator = (const BenchmarkContext &) = delete;
+
+    //Resets the command buffer and starts recording
+    void begin() {
+        vk.vkResetCommandPool(device, commandPool, 0);
+        VkCommandBufferBeginInfo commandBufferBeginInfo = {
+                VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, nullptr, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+                nullptr
+        };
+        check(vk.vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo), "vkBeginCommandBuffer()");
+    }
+
+    //Begins the render pass and binds the pipeline
+    void beginRenderPass() {
+        VkRenderPassBeginInfo renderPassBeginInfo = {
+                VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO, nullptr, renderPass, framebuffer, {{0, 0}, {1, 1}},
+                0, nullptr
+        };
+        vk.vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+        vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    }
+
+    void endRenderPass() {
+        vk.vkCmdEndRenderPass(commandBuffer);
+    }
+
+    void end() {
+        check(vk.vkEndCommandBuffer(commandBuffer), "vkEndCommandBuffer()");
+    }
+
+    //Submits the recorded command buffer to the graphics queue and waits for it
+    void submit(VkSemaphore waitSemaphore = VK_NULL_HANDLE, VkSemaphore signalSemaphore = VK_NULL_HANDLE) {
+        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        VkSubmitInfo submitInfo = {
+                VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                nullptr,
+                waitSemaphore != VK_NULL_HANDLE ? 1u : 0u,
+                &waitSemaphore,
+                &waitStage,
+                1,
+                &commandBuffer,
+                signalSemaphore != VK_NULL_HANDLE ? 1u : 0u,
+                &signalSemaphore
+        };
+        check(vk.vkQueueSubmit(vulkan.getGraphicsQueue(), 1, &submitInfo, fence), "vkQueueSubmit()");
+        vk.vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
+        vk.vkResetFences(device, 1, &fence);
+    }
+
+    //Getters
+    VkCommandBuffer getCommandBuffer() const { return commandBuffer; }
+    VkPipelineLayout getPipelineLayout() const { return pipelineLayout; }
+    VkDescriptorSet getDescriptorSet() const { return descriptorSet; }
+
+private:
+    static void check(VkResult errorDescription, const char *func) {
+        if(errorDescription != VK_SUCCESS) {
+            std::cout << PPGL::Exception("BenchmarkContext.h", __LINE__, func,
+                                         ("VkResult: " + std::to_string(int(errorDescription))).c_str());
+            throw std::runtime_error("Benchmark context Vulkan call failed!");
+        }
+    }
+
+    const PPGL::Vulkan &vulkan;
+    const PPGL::VulkanDispatch &vk;
+    VkDevice device;
+
+    VkCommandPool commandPool;
+    VkCommandBuffer commandBuffer;
+    VkFence fence;
+    VkRenderPass renderPass;
+    VkFramebuffer framebuffer;
+    VkDescriptorSetLayout descriptorSetLayout;
+    VkDescriptorPool descriptorPool;
+    VkDescriptorSet descriptorSet;
+    VkPipelineLayout pipelineLayout;
+    VkPipeline pipeline;
+};
+
+#endif //PPGL_BENCHMARKCONTEXT_H
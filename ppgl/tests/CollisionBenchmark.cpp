@@ -0,0 +1,139 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+/*
+ * Moves 10k bodies every frame and measures findCollisions on every narrowphase backend,
+ * then times the narrowphase alone on wide sprite pairs, where each row spans several words.
+ * Usage: ppgl_collision_benchmark [frames] [narrowphase tests]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Collision.h"
+
+struct MovingBody {
+    int x, y;
+    int velocityX, velocityY;
+};
+
+int main(int argc, char **argv) {
+    const uint32_t bodyCount = 10000;
+    const int worldSize = 4000;
+    uint32_t frames = argc > 1 ? uint32_t(std::strtoul(argv[1], nullptr, 10)) : 200;
+    uint32_t wideTests = argc > 2 ? uint32_t(std::strtoul(argv[2], nullptr, 10)) : 100000;
+
+    //Round 32x32 sprite
+    std::vector<uint8_t> pixels(32 * 32 * 4, 0);
+    for (int y = 0; y < 32; ++y) {
+        for (int x = 0; x < 32; ++x) {
+            pixels[(y * 32 + x) * 4 + 3] = (x - 16) * (x - 16) + (y - 16) * (y - 16) < 200 ? 255 : 0;
+        }
+    }
+    PPGL::CollisionMask circle(pixels.data(), 32, 32);
+
+    //512x256 sprites filled on even and on odd rows, the bounding boxes overlap but the pixels
+    //never do, so every test scans all shared rows of 8 words
+    const uint32_t wideWidth = 512, wideHeight = 256;
+    std::vector<uint8_t> evenPixels(wideWidth * wideHeight * 4, 0), oddPixels(wideWidth * wideHeight * 4, 0);
+    for (uint32_t y = 0; y < wideHeight; ++y) {
+        for (uint32_t x = 0; x < wideWidth; ++x) {
+            (y % 2 == 0 ? evenPixels : oddPixels)[(y * wideWidth + x) * 4 + 3] = 255;
+        }
+    }
+    PPGL::CollisionMask evenRows(evenPixels.data(), wideWidth, wideHeight);
+    PPGL::CollisionMask oddRows(oddPixels.data(), wideWidth, wideHeight);
+
+    //Unaligned horizontal offsets and even vertical offsets, which keep the rows apart
+    std::mt19937 offsetRandom(2);
+    std::vector<std::pair<int, int>> wideOffsets(1024);
+    for (std::pair<int, int> &offset : wideOffsets) {
+        offset = {int(offsetRandom() % 401) - 200, 2 * (int(offsetRandom() % 101) - 50)};
+    }
+
+    const PPGL::CollisionBackend backends[] = {
+            PPGL::CollisionBackend::Scalar, PPGL::CollisionBackend::SSE2, PPGL::CollisionBackend::AVX2
+    };
+    const char *backendNames[] = {"Scalar", "SSE2", "AVX2"};
+    for (uint32_t backend = 0; backend < 3; ++backend) {
+        if(!PPGL::setCollisionBackend(backends[backend])) {
+            std::cout << backendNames[backend] << ": not supported" << std::endl;
+            continue;
+        }
+
+        //Same bodies for every backend
+        std::mt19937 random(1);
+        PPGL::CollisionWorld world(32);
+        std::vector<MovingBody> bodies(bodyCount);
+        for (uint32_t i = 0; i < bodyCount; ++i) {
+            bodies[i] = {int(random() % worldSize), int(random() % worldSize),
+                         int(random() % 7) - 3, int(random() % 7) - 3};
+            world.addBody(circle, bodies[i].x, bodies[i].y);
+        }
+
+        uint64_t collisions = 0, narrowphaseTests = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            for (uint32_t i = 0; i < bodyCount; ++i) {
+                MovingBody &body = bodies[i];
+                //Bounce off the world borders
+                if(body.x + body.velocityX < 0 || body.x + body.velocityX > worldSize) {
+                    body.velocityX = -body.velocityX;
+                }
+                if(body.y + body.velocityY < 0 || body.y + body.velocityY > worldSize) {
+                    body.velocityY = -body.velocityY;
+                }
+                body.x += body.velocityX;
+                body.y += body.velocityY;
+                world.setPosition(i, body.x, body.y);
+            }
+            collisions += world.findCollisions().size();
+            narrowphaseTests += world.getStats().narrowphaseTests;
+        }
+        double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << backendNames[backend] << ": " << time / frames << " ms/frame, "
+                  << double(narrowphaseTests) / frames << " narrowphase tests/frame, "
+                  << double(collisions) / frames << " collisions/frame" << std::endl;
+
+        uint32_t wideOverlaps = 0;
+        start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < wideTests; ++i) {
+            const std::pair<int, int> &offset = wideOffsets[i % wideOffsets.size()];
+            wideOverlaps += PPGL::overlaps(evenRows, 0, 0, oddRows, offset.first, offset.second) ? 1 : 0;
+        }
+        time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << backendNames[backend] << ": " << time / wideTests << " ns per " << wideWidth << "x"
+                  << wideHeight << " narrowphase test, " << wideOverlaps << " overlaps" << std::endl;
+    }
+
+    return 0;
+}
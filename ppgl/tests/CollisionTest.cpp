@@ -0,0 +1,196 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+/*
+ * Compares the collision module against a naive per pixel reference
+ * on every narrowphase backend the CPU supports.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "Collision.h"
+
+//Naive reference: tests every pixel of a against the pixel of b at the same position
+static bool naiveOverlaps(const PPGL::CollisionMask &a, int ax, int ay, const PPGL::CollisionMask &b, int bx, int by) {
+    for (int y = 0; y < int(a.getHeight()); ++y) {
+        for (int x = 0; x < int(a.getWidth()); ++x) {
+            if(a.test(x, y) && b.test(x + ax - bx, y + ay - by)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+//Rejects pairs that cannot share a pixel, keeps the brute force search fast
+static bool boundsOverlap(const PPGL::CollisionMask &a, int ax, int ay, const PPGL::CollisionMask &b, int bx, int by) {
+    return ax < bx + int(b.getWidth()) && bx < ax + int(a.getWidth()) &&
+           ay < by + int(b.getHeight()) && by < ay + int(a.getHeight());
+}
+
+//Mask with random solid pixels, density in per mille
+static PPGL::CollisionMask randomMask(std::mt19937 &random, uint32_t width, uint32_t height, uint32_t density) {
+    std::vector<uint8_t> pixels(size_t(width) * height * 4, 0);
+    for (size_t i = 0; i < size_t(width) * height; ++i) {
+        pixels[i * 4 + 3] = random() % 1000 < density ? 255 : 0;
+    }
+    return PPGL::CollisionMask(pixels.data(), width, height);
+}
+
+static const char *backendName(PPGL::CollisionBackend backend) {
+    switch (backend) {
+        case PPGL::CollisionBackend::Scalar: return "Scalar";
+        case PPGL::CollisionBackend::SSE2: return "SSE2";
+        case PPGL::CollisionBackend::AVX2: return "AVX2";
+    }
+    return "-";
+}
+
+struct Body {
+    uint32_t mask;
+    int x, y;
+    bool active;
+};
+
+int main() {
+    std::mt19937 random(1);
+    uint32_t failures = 0;
+
+    //Widths around the word sizes of every backend, densities from sparse to solid
+    std::vector<PPGL::CollisionMask> masks;
+    const uint32_t widths[] = {1, 7, 63, 64, 65, 127, 128, 129, 255, 256, 257};
+    for (uint32_t width : widths) {
+        masks.push_back(randomMask(random, width, 1 + random() % 40, 20));
+        masks.push_back(randomMask(random, width, 1 + random() % 40, 500));
+        masks.push_back(randomMask(random, width, 1 + random() % 40, 1000));
+    }
+    for (uint32_t i = 0; i < 16; ++i) {
+        masks.push_back(randomMask(random, 1 + random() % 300, 1 + random() % 80, random() % 200));
+    }
+
+    const PPGL::CollisionBackend backends[] = {
+            PPGL::CollisionBackend::Scalar, PPGL::CollisionBackend::SSE2, PPGL::CollisionBackend::AVX2
+    };
+    for (PPGL::CollisionBackend backend : backends) {
+        if(!PPGL::setCollisionBackend(backend)) {
+            std::cout << backendName(backend) << ": not supported, skipped" << std::endl;
+            continue;
+        }
+
+        /*
+         * Narrowphase against the naive reference
+         */
+        uint32_t narrowphaseFailures = 0;
+        for (uint32_t i = 0; i < 20000; ++i) {
+            const PPGL::CollisionMask &a = masks[random() % masks.size()];
+            const PPGL::CollisionMask &b = masks[random() % masks.size()];
+            int ax = int(random() % 600) - 300;
+            int ay = int(random() % 200) - 100;
+            int bx = ax + int(random() % 640) - 320;
+            int by = ay + int(random() % 120) - 60;
+            if(PPGL::overlaps(a, ax, ay, b, bx, by) != naiveOverlaps(a, ax, ay, b, bx, by)) {
+                ++narrowphaseFailures;
+            }
+        }
+
+        /*
+         * World against a brute force pair search
+         */
+        uint32_t worldFailures = 0;
+        size_t checkedPairs = 0;
+        const uint32_t cellSizes[] = {7, 32, 64, 200};
+        for (uint32_t cellSize : cellSizes) {
+            PPGL::CollisionWorld world(cellSize);
+            std::vector<Body> bodies;
+            for (uint32_t i = 0; i < 600; ++i) {
+                Body body = {uint32_t(random() % masks.size()), int(random() % 1600) - 800,
+                             int(random() % 1600) - 800, true};
+                bodies.push_back(body);
+                world.addBody(masks[body.mask], body.x, body.y);
+            }
+
+            //Removal, id reuse and moves between two queries
+            for (uint32_t step = 0; step < 2; ++step) {
+                for (uint32_t i = 0; i < 20; ++i) {
+                    uint32_t id = random() % bodies.size();
+                    if(bodies[id].active) {
+                        world.removeBody(id);
+                        bodies[id].active = false;
+                    }
+                }
+                Body body = {uint32_t(random() % masks.size()), 0, 0, true};
+                uint32_t id = world.addBody(masks[body.mask], body.x, body.y);
+                if(id >= bodies.size()) {
+                    bodies.resize(id + 1);
+                }
+                bodies[id] = body;
+                for (uint32_t i = 0; i < bodies.size(); ++i) {
+                    if(bodies[i].active && random() % 2 == 0) {
+                        bodies[i].x += int(random() % 41) - 20;
+                        bodies[i].y += int(random() % 41) - 20;
+                        world.setPosition(i, bodies[i].x, bodies[i].y);
+                    }
+                }
+
+                const std::vector<std::pair<uint32_t, uint32_t>> &pairs = world.findCollisions();
+                std::set<std::pair<uint32_t, uint32_t>> found(pairs.begin(), pairs.end());
+                std::set<std::pair<uint32_t, uint32_t>> expected;
+                for (uint32_t i = 0; i < bodies.size(); ++i) {
+                    for (uint32_t j = i + 1; j < bodies.size(); ++j) {
+                        const Body &a = bodies[i];
+                        const Body &b = bodies[j];
+                        if(a.active && b.active && boundsOverlap(masks[a.mask], a.x, a.y, masks[b.mask], b.x, b.y) &&
+                           naiveOverlaps(masks[a.mask], a.x, a.y, masks[b.mask], b.x, b.y)) {
+                            expected.insert({i, j});
+                        }
+                    }
+                }
+
+                checkedPairs += expected.size();
+
+                //Every pair once, lower id first
+                if(found != expected || found.size() != pairs.size() ||
+                   std::any_of(pairs.begin(), pairs.end(),
+                               [](const std::pair<uint32_t, uint32_t> &pair) { return pair.first >= pair.second; })) {
+                    std::cout << backendName(backend) << ": cell size " << cellSize << " found " << pairs.size()
+                              << " pairs, expected " << expected.size() << std::endl;
+                    ++worldFailures;
+                }
+            }
+        }
+
+        std::cout << backendName(backend) << ": " << narrowphaseFailures << " narrowphase failures, "
+                  << worldFailures << " world failures, " << checkedPairs << " colliding pairs checked" << std::endl;
+        failures += narrowphaseFailures + worldFailures;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+/*
+ * Records descriptor set binds and draws through the PPGL dispatch table
+ * and through the exported loader functions and compares the cost per call.
+ * Usage: ppgl_dispatch_benchmark [calls]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+#include "BenchmarkContext.h"
+#include "Window.h"
+
+int main(int argc, char **argv) {
+    uint32_t calls = argc > 1 ? uint32_t(std::strtoul(argv[1], nullptr, 10)) : 100000;
+    const uint32_t repeats = 10;
+
+    //glfw has to be initialized before Vulkan
+    PPGL::Window window;
+    PPGL::Vulkan vulkan;
+    vulkan.init();
+
+    BenchmarkContext context(vulkan);
+    const PPGL::VulkanDispatch &vk = vulkan.getDispatch();
+    VkCommandBuffer commandBuffer = context.getCommandBuffer();
+    VkPipelineLayout pipelineLayout = context.getPipelineLayout();
+    VkDescriptorSet descriptorSet = context.getDescriptorSet();
+
+    //Best of several recordings, both paths alternate so clock changes hit both
+    const char *pathNames[2] = {"Dispatch table", "Loader exports"};
+    double bestTimes[2] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+    for (uint32_t repeat = 0; repeat < repeats; ++repeat) {
+        for (uint32_t path = 0; path < 2; ++path) {
+            context.begin();
+            context.beginRenderPass();
+
+            auto start = std::chrono::steady_clock::now();
+            if(path == 0) {
+                for (uint32_t i = 0; i < calls; ++i) {
+                    vk.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1,
+                                               &descriptorSet, 0, nullptr);
+                    vk.vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+                }
+            } else {
+                for (uint32_t i = 0; i < calls; ++i) {
+                    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1,
+                                            &descriptorSet, 0, nullptr);
+                    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+                }
+            }
+            double time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            bestTimes[path] = std::min(bestTimes[path], time);
+
+            context.endRenderPass();
+            context.end();
+        }
+    }
+
+    for (uint32_t path = 0; path < 2; ++path) {
+        std::cout << pathNames[path] << ": " << bestTimes[path] / (2.0 * calls) << " ns/call" << std::endl;
+    }
+    std::cout << "Saving: " << (bestTimes[1] - bestTimes[0]) / (2.0 * calls) << " ns/call" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+/*
+ * Lays out labels every frame with Font::layout, once with static text that hits the
+ * layout cache and once with text that changes every frame, for bitmap and SDF fonts.
+ * Measures the layout only, ppgl_text_benchmark adds the atlas upload and instance batching.
+ * Usage: ppgl_font_benchmark [frames]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Font.h"
+
+static const uint32_t labelCount = 200;
+
+//Lays out every label for the given number of frames, returns the milliseconds per frame
+static double runFrames(PPGL::Font &font, uint32_t frames, bool changing, uint64_t &glyphs) {
+    std::vector<std::string> labels(labelCount);
+    for (uint32_t i = 0; i < labelCount; ++i) {
+        labels[i] = "Label " + std::to_string(i) + ": The quick brown fox";
+    }
+
+    glyphs = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        for (uint32_t i = 0; i < labelCount; ++i) {
+            if(changing) {
+                glyphs += font.layout(labels[i] + " " + std::to_string(frame)).glyphs.size();
+            } else {
+                glyphs += font.layout(labels[i]).glyphs.size();
+            }
+        }
+        font.collectLayouts(2);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+int main(int argc, char **argv) {
+    uint32_t frames = argc > 1 ? uint32_t(std::strtoul(argv[1], nullptr, 10)) : 500;
+
+    //RGBA8 grid of 8x16 cells for the codepoints 32 to 127 with a different shape in every cell
+    const uint32_t cellWidth = 8, cellHeight = 16, columns = 16, rows = 6;
+    const uint32_t width = cellWidth * columns, height = cellHeight * rows;
+    std::vector<uint8_t> image(size_t(width) * height * 4, 0);
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            uint32_t cell = (y / cellHeight) * columns + x / cellWidth;
+            if((x % cellWidth + y % cellHeight + cell) % 3 == 0) {
+                image[(size_t(y) * width + x) * 4 + 3] = 255;
+            }
+        }
+    }
+    PPGL::BitmapGlyphSource source(image.data(), width, height, cellWidth, cellHeight);
+
+    for (PPGL::FontType type : {PPGL::FontType::Bitmap, PPGL::FontType::SDF}) {
+        for (bool changing : {false, true}) {
+            PPGL::Font font(source, type);
+            uint64_t glyphs;
+            double frameTime = runFrames(font, frames, changing, glyphs);
+            const PPGL::FontStats &stats = font.getStats();
+
+            std::cout << (type == PPGL::FontType::SDF ? "SDF" : "Bitmap") << ", "
+                      << (changing ? "changing" : "static") << " text: " << frameTime << " ms/frame, "
+                      << double(glyphs) / (frameTime * frames) << " glyphs/ms, "
+                      << stats.layoutHits << " hits, " << stats.layoutMisses << " misses, "
+                      << stats.cachedLayouts << " cached layouts" << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+/*
+ * Compares the CPU recording time of the GPU driven path, culling pass plus
+ * indirect draws, against the classic path of CPU culling and one draw per object.
+ * Usage: ppgl_gpu_driven_benchmark [objects]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+
+#include "BenchmarkContext.h"
+#include "GpuDrivenRenderer.h"
+#include "Window.h"
+
+int main(int argc, char **argv) {
+    uint32_t objectCount = argc > 1 ? uint32_t(std::strtoul(argv[1], nullptr, 10)) : 100000;
+    const uint32_t repeats = 10;
+
+    //glfw has to be initialized before Vulkan
+    PPGL::Window window;
+    PPGL::Vulkan vulkan;
+    vulkan.init();
+
+    BenchmarkContext context(vulkan);
+    VkCommandBuffer commandBuffer = context.getCommandBuffer();
+    const PPGL::VulkanDispatch &vk = vulkan.getDispatch();
+
+    //One triangle shared by every object
+    VkBuffer indexBuffer;
+    VkDeviceMemory indexMemory;
+    vulkan.createBuffer(3 * sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                        indexBuffer, indexMemory);
+
+    double bestTimes[2] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+    uint32_t classicDraws = 0;
+    bool drawIndirectCount;
+    {
+        PPGL::GpuDrivenRenderer renderer(vulkan, objectCount, 1);
+        drawIndirectCount = renderer.usesDrawIndirectCount();
+
+        //Objects around the clip space volume, about a quarter of them is visible
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+        for (uint32_t i = 0; i < objectCount; ++i) {
+            PPGL::GpuDrawObject object = {
+                    {distribution(random), distribution(random), distribution(random) * 0.5f + 0.5f},
+                    0.01f, 3, 0, 0, 0
+            };
+            renderer.addObject(object);
+        }
+        const float identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+        renderer.setFrustum(identity);
+
+        //The first recording uploads all objects, it is not measured
+        context.begin();
+        renderer.recordCulling(commandBuffer, 0);
+        context.end();
+
+        for (uint32_t repeat = 0; repeat < repeats; ++repeat) {
+            //GPU driven: culling pass and indirect draws
+            context.begin();
+            auto start = std::chrono::steady_clock::now();
+            renderer.recordCulling(commandBuffer, 0);
+            double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            context.beginRenderPass();
+            vk.vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+            renderer.recordDraw(commandBuffer);
+            bestTimes[0] = std::min(bestTimes[0], time + renderer.getStats().drawRecordTime);
+            context.endRenderPass();
+            context.end();
+
+            //Classic: CPU culling and one draw per visible object
+            context.begin();
+            context.beginRenderPass();
+            vk.vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+            renderer.recordDrawClassic(commandBuffer);
+            bestTimes[1] = std::min(bestTimes[1], renderer.getStats().classicRecordTime);
+            classicDraws = renderer.getStats().classicDraws;
+            context.endRenderPass();
+            context.end();
+        }
+    }
+    vulkan.destroyBuffer(indexBuffer, indexMemory);
+
+    std::cout << objectCount << " objects, " << classicDraws << " visible" << std::endl;
+    std::cout << "GPU driven (" << (drawIndirectCount ? "vkCmdDrawIndexedIndirectCount" : "vkCmdDrawIndexedIndirect")
+              << "): " << bestTimes[0] << " ms" << std::endl;
+    std::cout << "Classic (vkCmdDrawIndexed per object): " << bestTimes[1] << " ms" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+/*
+ * Steps 1k, 64k and 1M particles at full capacity and prints the GPU simulation cost per particle.
+ * Every step is consumed by a graphics submission, like a frame drawing the particles would.
+ * Usage: ppgl_particle_benchmark [steps]
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include "BenchmarkContext.h"
+#include "ParticleSystem.h"
+#include "Window.h"
+
+int main(int argc, char **argv) {
+    uint32_t steps = argc > 1 ? uint32_t(std::strtoul(argv[1], nullptr, 10)) : 100;
+    const float deltaTime = 1.0f / 60.0f;
+    const float lifetime = 2.0f;
+
+    //glfw has to be initialized before Vulkan
+    PPGL::Window window;
+    PPGL::Vulkan vulkan;
+    vulkan.init();
+
+    BenchmarkContext context(vulkan);
+    const PPGL::VulkanDispatch &vk = vulkan.getDispatch();
+
+    //Simulation to frame and frame to simulation, as in a render loop
+    VkSemaphore simulatedSemaphore, drawnSemaphore;
+    VkSemaphoreCreateInfo semaphoreCreateInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, nullptr, 0};
+    vk.vkCreateSemaphore(vulkan.getDevice(), &semaphoreCreateInfo, vulkan.getAllocator(), &simulatedSemaphore);
+    vk.vkCreateSemaphore(vulkan.getDevice(), &semaphoreCreateInfo, vulkan.getAllocator(), &drawnSemaphore);
+    bool drawn = false;
+
+    for (uint32_t maxParticles : {1u << 10, 1u << 16, 1u << 20}) {
+        PPGL::ParticleSystem particles(vulkan, maxParticles);
+        //Emits as many particles per lifetime as fit, so the system runs full
+        PPGL::ParticleEmitter emitter = {
+                {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, 0.5f, {1.0f, 1.0f, 1.0f, 1.0f}, lifetime,
+                float(maxParticles) / lifetime
+        };
+        particles.addEmitter(emitter);
+        particles.setForces(0.0f, -9.81f, 0.0f, 0.1f);
+
+        //The first lifetime fills the system, the stats lag one step behind
+        uint32_t warmupSteps = uint32_t(lifetime / deltaTime) + 1;
+        double nanosecondsPerParticle = 0.0, simulationTime = 0.0;
+        uint32_t aliveParticles = 0;
+        for (uint32_t step = 0; step < warmupSteps + steps + 1; ++step) {
+            particles.simulate(deltaTime, drawn ? drawnSemaphore : VK_NULL_HANDLE, simulatedSemaphore);
+            context.begin();
+            context.end();
+            context.submit(simulatedSemaphore, drawnSemaphore);
+            drawn = true;
+
+            if(step > warmupSteps) {
+                const PPGL::ParticleStats &stats = particles.getStats();
+                nanosecondsPerParticle += stats.nanosecondsPerParticle;
+                simulationTime += stats.simulationTime;
+                aliveParticles += stats.aliveParticles;
+            }
+        }
+
+        std::cout << maxParticles << " particles (" << aliveParticles / steps << " alive): ";
+        if(simulationTime == 0.0) {
+            std::cout << "the compute queue has no timestamps" << std::endl;
+        } else {
+            std::cout << nanosecondsPerParticle / steps << " ns/particle, " << simulationTime / steps
+                      << " ms/step" << std::endl;
+        }
+    }
+
+    vk.vkDestroySemaphore(vulkan.getDevice(), drawnSemaphore, vulkan.getAllocator());
+    vk.vkDestroySemaphore(vulkan.getDevice(), simulatedSemaphore, vulkan.getAllocator());
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+/*
+ * Checks the eviction order of the ResidencyManager on a fake 1000 byte heap,
+ * with evict and restore callbacks that only count their calls. Needs no device.
+ */
+
+#include <iostream>
+#include <vector>
+
+#include "ResidencyManager.h"
+
+static uint32_t failures = 0;
+
+static void check(bool condition, const char *description) {
+    if(!condition) {
+        std::cout << "Failed: " << description << std::endl;
+        ++failures;
+    }
+}
+
+//One heap of 1000 bytes, the budget is the whole heap as the fake driver reports none
+struct FakeHeap {
+    VkPhysicalDeviceMemoryProperties memoryProperties{};
+    std::vector<uint32_t> evictions;
+    std::vector<uint32_t> restores;
+
+    FakeHeap() {
+        memoryProperties.memoryTypeCount = 1;
+        memoryProperties.memoryTypes[0].heapIndex = 0;
+        memoryProperties.memoryHeapCount = 1;
+        memoryProperties.memoryHeaps[0].size = 1000;
+    }
+
+    PPGL::ResidencyManager createManager() {
+        return PPGL::ResidencyManager(memoryProperties, [](VkDeviceSize *, VkDeviceSize *) { return false; }, 2, 1.0f);
+    }
+
+    //Tracks a resource whose callbacks record the given name
+    uint32_t track(PPGL::ResidencyManager &manager, VkDeviceSize size, uint32_t priority, uint32_t name) {
+        return manager.track(size, 0, priority, [this, name]() { evictions.push_back(name); },
+                             [this, name]() { restores.push_back(name); });
+    }
+};
+
+int main() {
+    //Least recently used first, tracking evicts right away
+    {
+        FakeHeap heap;
+        PPGL::ResidencyManager manager = heap.createManager();
+        uint32_t a = heap.track(manager, 300, 0, 0);
+        uint32_t b = heap.track(manager, 300, 0, 1);
+        uint32_t c = heap.track(manager, 300, 0, 2);
+        manager.update();
+        manager.use(a);
+        manager.update();
+        manager.use(b);
+        manager.update();
+        manager.update();
+
+        //C was used first, then A, B last
+        uint32_t d = heap.track(manager, 500, 0, 3);
+        check(heap.evictions == std::vector<uint32_t>({2, 0}), "LRU: C then A evicted when D is tracked");
+        check(!manager.isResident(c) && !manager.isResident(a), "LRU: C and A evicted");
+        check(manager.isResident(b) && manager.isResident(d), "LRU: B and D resident");
+        check(manager.getStats().heaps[0].residentBytes == 800, "LRU: 800 resident bytes");
+        check(manager.getStats().heaps[0].evictedBytes == 600, "LRU: 600 evicted bytes");
+
+        //Restoring A makes room by evicting B, which was used before D got tracked
+        manager.update();
+        manager.update();
+        check(manager.use(a), "LRU: A restored");
+        check(heap.restores == std::vector<uint32_t>({0}), "LRU: restore of A called once");
+        check(heap.evictions == std::vector<uint32_t>({2, 0, 1}), "LRU: B evicted for A");
+        check(manager.isResident(a) && !manager.isResident(b), "LRU: A resident, B evicted");
+        check(!manager.use(a), "LRU: resident A not restored again");
+    }
+
+    //Lower priority first, even if used more recently
+    {
+        FakeHeap heap;
+        PPGL::ResidencyManager manager = heap.createManager();
+        uint32_t a = heap.track(manager, 400, 1, 0);
+        manager.update();
+        uint32_t b = heap.track(manager, 400, 0, 1);
+        manager.update();
+        manager.update();
+
+        heap.track(manager, 400, 0, 2);
+        check(heap.evictions == std::vector<uint32_t>({1}), "Priority: only B evicted");
+        check(manager.isResident(a) && !manager.isResident(b), "Priority: A resident, B evicted");
+
+        //Raising the priority of B protects it over A
+        manager.update();
+        manager.update();
+        manager.setPriority(b, 2);
+        manager.use(b);
+        check(heap.evictions == std::vector<uint32_t>({1, 2}), "Priority: C evicted for B");
+        manager.update();
+        manager.update();
+        manager.setBudgetFraction(0.5f);
+        manager.update();
+        check(heap.evictions == std::vector<uint32_t>({1, 2, 0}), "Priority: A evicted before B");
+        check(manager.isResident(b), "Priority: B resident");
+    }
+
+    //Resources used in the last framesInFlight frames are never evicted
+    {
+        FakeHeap heap;
+        PPGL::ResidencyManager manager = heap.createManager();
+        uint32_t a = heap.track(manager, 400, 0, 0);
+        uint32_t b = heap.track(manager, 400, 0, 1);
+        manager.use(a);
+        manager.use(b);
+        heap.track(manager, 400, 0, 2);
+        check(heap.evictions.empty(), "Frames in flight: nothing evicted in the frame of use");
+        check(manager.getStats().heaps[0].residentBytes == 1200, "Frames in flight: heap stays over budget");
+
+        manager.update();
+        check(heap.evictions.empty(), "Frames in flight: nothing evicted one frame later");
+
+        manager.update();
+        check(heap.evictions.size() == 1, "Frames in flight: one eviction after framesInFlight frames");
+        check(manager.getStats().evictions == 1 && manager.getStats().heaps[0].residentBytes == 800,
+              "Frames in flight: heap within budget");
+
+        //Untracking frees the id and its bytes
+        manager.untrack(a);
+        check(manager.getStats().residentResources + manager.getStats().evictedResources == 2,
+              "Untrack: two resources left");
+        check(heap.track(manager, 100, 0, 3) == a, "Untrack: id reused");
+    }
+
+    std::cout << failures << " residency failures" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+/*------------------------------------------------------------------------------------------
+ * MIT License
+ *
+ * Copyright (c) 2022 Juna Knop
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * -----------------------------------------------------------------------------------------
+ */
+
+/*
+ * Draws labels every frame through TextRenderer, once with static text and once with text that
+ * changes every frame, for bitmap and SDF fonts. Times drawText plus recordUpload, which covers
+ * the layout, the atlas upload and the per page instance batching.
+ * Usage: ppgl_text_benchmark [frames]
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BenchmarkContext.h"
+#include "TextRenderer.h"
+#include "Window.h"
+
+int main(int argc, char **argv) {
+    uint32_t frames = argc > 1 ? uint32_t(std::strtoul(argv[1], nullptr, 10)) : 500;
+    const uint32_t labelCount = 200;
+
+    //glfw has to be initialized before Vulkan
+    PPGL::Window window;
+    PPGL::Vulkan vulkan;
+    vulkan.init();
+
+    BenchmarkContext context(vulkan);
+    VkCommandBuffer commandBuffer = context.getCommandBuffer();
+
+    //RGBA8 grid of 8x16 cells for the codepoints 32 to 127 with a different shape in every cell
+    const uint32_t cellWidth = 8, cellHeight = 16, columns = 16, rows = 6;
+    const uint32_t width = cellWidth * columns, height = cellHeight * rows;
+    std::vector<uint8_t> image(size_t(width) * height * 4, 0);
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            uint32_t cell = (y / cellHeight) * columns + x / cellWidth;
+            if((x % cellWidth + y % cellHeight + cell) % 3 == 0) {
+                image[(size_t(y) * width + x) * 4 + 3] = 255;
+            }
+        }
+    }
+    PPGL::BitmapGlyphSource source(image.data(), width, height, cellWidth, cellHeight);
+
+    std::vector<std::string> labels(labelCount);
+    for (uint32_t i = 0; i < labelCount; ++i) {
+        labels[i] = "Label " + std::to_string(i) + ": The quick brown fox";
+    }
+
+    for (PPGL::FontType type : {PPGL::FontType::Bitmap, PPGL::FontType::SDF}) {
+        for (bool changing : {false, true}) {
+            PPGL::Font font(source, type);
+            //Every frame is submitted and waited for, so one frame in flight is enough
+            PPGL::TextRenderer renderer(vulkan, 1u << 16, 1);
+
+            double cpuTime = 0.0;
+            uint64_t glyphs = 0, uploadedBytes = 0;
+            //The first frame rasterizes and uploads every glyph, it is not measured
+            for (uint32_t frame = 0; frame <= frames; ++frame) {
+                for (uint32_t i = 0; i < labelCount; ++i) {
+                    float y = float(i * cellHeight);
+                    if(changing) {
+                        renderer.drawText(font, labels[i] + " " + std::to_string(frame), 0.0f, y);
+                    } else {
+                        renderer.drawText(font, labels[i], 0.0f, y);
+                    }
+                }
+                context.begin();
+                renderer.recordUpload(commandBuffer, 0);
+                context.end();
+                context.submit();
+
+                if(frame > 0) {
+                    const PPGL::TextStats &stats = renderer.getStats();
+                    cpuTime += stats.cpuTime;
+                    glyphs += stats.glyphs;
+                    uploadedBytes += stats.uploadedBytes;
+                }
+            }
+
+            std::cout << (type == PPGL::FontType::SDF ? "SDF" : "Bitmap") << ", "
+                      << (changing ? "changing" : "static") << " text: " << cpuTime / frames << " ms/frame, "
+                      << double(glyphs) / cpuTime << " glyphs/ms, " << uploadedBytes / frames
+                      << " uploaded bytes/frame" << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,6 @@
+#version 450
+
+//Rasterization is discarded, benchmarks only measure command recording
+void main() {
+    gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+}